@@ -1,66 +1,90 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
-#include <ios>
 #include <iterator>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
+#include <string_view>
+#include <vector>
 
 #include "common.h"
+#include "cursor.h"
 
 namespace {
 
-class energy_report;
-
-static std::istream& operator>>(std::istream&, energy_report&);
-
 class energy_report {
-	friend std::istream& operator>>(std::istream&, energy_report&);
 public:
 	constexpr energy_report() noexcept = default;
 
-	[[nodiscard]] constexpr std::uintmax_t max() const noexcept {
-		return *std::cbegin(top);
-	}
-	
 	[[nodiscard]] constexpr std::uintmax_t top3() const noexcept {
-		return std::accumulate(std::cbegin(top), std::cend(top), 0);
+		return std::accumulate(std::cbegin(top), std::cend(top),
+		                       std::uintmax_t{0});
 	}
 
+	void add(std::uintmax_t elf_energy);
+
 private:
 	std::uintmax_t top[3]{0, 0, 0};
 };
 
-static std::istream& operator>>(std::istream& in, energy_report& report)
+void energy_report::add(const std::uintmax_t elf_energy)
 {
-	std::uintmax_t elf_energy = 0;
-	std::uintmax_t item_energy;
-	while (in >> item_energy) {
-		elf_energy += item_energy;
-		if (in.get() != in.widen('\n')) [[unlikely]] {
-			in.setstate(std::ios_base::failbit);
-			break;
-		}
-		if (in.peek() == in.widen('\n'))
-			break;
-	}
-	const auto end = std::end(report.top);
-	const auto it = std::lower_bound(std::begin(report.top), end,
-	                                 elf_energy, std::greater{});
+	const auto end = std::end(top);
+	const auto it = std::lower_bound(std::begin(top), end, elf_energy,
+	                                 std::greater{});
 	if (it != end) {
 		std::shift_right(it, end, 1);
 		*it = elf_energy;
 	}
-	return in;
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in);
+
+	puzzle_output part1() override {
+		return *std::max_element(elves.cbegin(), elves.cend());
+	}
+
+	puzzle_output part2() override;
+
+private:
+	// Energy carried by each elf, never empty
+	std::vector<std::uintmax_t> elves{};
+};
+
+// Elves are separated by blank lines and carry one item per line
+solution::solution(std::string_view in)
+{
+	std::uintmax_t elf_energy = 0;
+	while (!in.empty()) {
+		const std::string_view line = next_line(in);
+		if (line.empty()) {
+			elves.push_back(elf_energy);
+			elf_energy = 0;
+			continue;
+		}
+		cursor c{line};
+		std::uintmax_t item_energy;
+		if (!c.read_uint(item_energy) || !c.empty()) [[unlikely]]
+			throw std::runtime_error("Error while reading puzzle input");
+		elf_energy += item_energy;
+	}
+	elves.push_back(elf_energy);
 }
 
-template<> output_pair day<1>(std::istream& in)
+puzzle_output solution::part2()
 {
 	energy_report report;
-	while (in >> report);
-	if (!in.eof()) [[unlikely]]
-		throw std::runtime_error("Error while reading puzzle input");
-	return {report.max(), report.top3()};
+	for (const std::uintmax_t e : elves)
+		report.add(e);
+	return report.top3();
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<1>(std::string_view in)
+{
+	return std::make_unique<solution>(in);
 }
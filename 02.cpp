@@ -5,16 +5,19 @@
 #include <istream>
 #include <iterator>
 #include <locale>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include "common.h"
 
 enum class decision { rock, paper, scissors };
 
-struct score {
-	std::uintmax_t naive;
-	std::uintmax_t strategic;
+// The opponent's shape and the second column, 0 to 2 each
+struct guide_line {
+	int a;
+	int b;
 };
 
 namespace {
@@ -31,7 +34,7 @@ compute_score(const decision a, const decision b) noexcept
 }
 
 template<char P, char Q, char R>
-constexpr int parse(std::istream::char_type c) noexcept
+constexpr int parse_decision(std::istream::char_type c) noexcept
 {
 	constexpr const std::istream::char_type lookup[3]{P, Q, R};
 	const auto it = std::find(std::execution::unseq, std::cbegin(lookup),
@@ -41,43 +44,47 @@ constexpr int parse(std::istream::char_type c) noexcept
 	return static_cast<int>(std::distance(std::cbegin(lookup), it));
 }
 
-static std::istream& operator>>(std::istream& in, score& s)
+static std::istream& operator>>(std::istream& in, guide_line& r)
 {
 	std::istream::char_type buf[3];
 	if (!in.read(buf, std::size(buf)))
 		return in;
-	const int a_data = parse<'A', 'B', 'C'>(buf[0]);
+	const int a_data = parse_decision<'A', 'B', 'C'>(buf[0]);
 	if (a_data < 0) [[unlikely]] {
 		in.setstate(std::ios_base::failbit);
 		return in;
 	}
-	const decision a = static_cast<decision>(a_data);
 	if (buf[1] != ' ') [[unlikely]] {
 		in.setstate(std::ios_base::failbit);
 		return in;
 	}
-	const int b_data = parse<'X', 'Y', 'Z'>(buf[2]);
+	const int b_data = parse_decision<'X', 'Y', 'Z'>(buf[2]);
 	if (b_data < 0) [[unlikely]] {
 		in.setstate(std::ios_base::failbit);
 		return in;
 	}
-	const decision b_naive = static_cast<decision>(b_data);
-	const decision b_strategy =
-		static_cast<decision>((a_data + b_data + 2) % 3);
-	s.naive += compute_score(a, b_naive);
-	s.strategic += compute_score(a, b_strategy);
+	r = {a_data, b_data};
 	return in;
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in);
+	puzzle_output part1() override;
+	puzzle_output part2() override;
+
+private:
+	std::vector<guide_line> rounds{};
+};
 
-template<> output_pair day<2>(std::istream& in)
+solution::solution(std::istream& in)
 {
 	using traits = std::istream::traits_type;
 	std::locale loc = in.getloc();
-	score s{0, 0};
 	std::uintmax_t line = 1;
-	while (in >> s) {
+	guide_line r;
+	while (in >> r) {
+		rounds.push_back(r);
 		std::istream::int_type c;
 		while ((c = in.peek()) != traits::eof()
 		       && std::isspace(traits::to_char_type(c), loc)) {
@@ -91,5 +98,33 @@ template<> output_pair day<2>(std::istream& in)
 		os << "Puzzle input error occurred on line " << line;
 		throw std::runtime_error(os.str());
 	}
-	return {s.naive, s.strategic};
+}
+
+// The second column is the shape to play
+puzzle_output solution::part1()
+{
+	std::uintmax_t total = 0;
+	for (const guide_line& r : rounds) {
+		total += compute_score(static_cast<decision>(r.a),
+		                       static_cast<decision>(r.b));
+	}
+	return total;
+}
+
+// The second column is the outcome: lose, draw or win
+puzzle_output solution::part2()
+{
+	std::uintmax_t total = 0;
+	for (const guide_line& r : rounds) {
+		total += compute_score(static_cast<decision>(r.a),
+		                       static_cast<decision>((r.a + r.b + 2) % 3));
+	}
+	return total;
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<2>(std::istream& in)
+{
+	return std::make_unique<solution>(in);
 }
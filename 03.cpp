@@ -1,48 +1,20 @@
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <execution>
 #include <istream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "common.h"
 
 namespace {
 
-class parser;
-
-static std::istream& operator>>(std::istream& in, parser& p);
-
-class parser {
-	friend std::istream& operator>>(std::istream&, parser&);
-public:
-	constexpr parser() noexcept = default;
-
-	[[nodiscard]] constexpr std::uintmax_t priority() const noexcept {
-		return sum_priority;
-	}
-
-	[[nodiscard]] constexpr std::uintmax_t badges() const noexcept {
-		return sum_badges;
-	}
-
-	[[nodiscard]] constexpr bool operator!() const noexcept {
-		return group != 0;
-	}
-
-private:
-	void visit_item(char t);
-	[[nodiscard]] constexpr std::uintmax_t group_badge() const;
-
-	std::uintmax_t sum_priority = 0;
-	std::uintmax_t sum_badges = 0;
-	std::uint_fast64_t present[3]{0, 0, 0};
-	std::size_t group = 0;
-};
-
 constexpr const char item_types[53] =
 	"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
@@ -92,71 +64,79 @@ static std::uintmax_t common_priority(std::string rucksack)
 	return item_priority(common);
 }
 
-void parser::visit_item(const char t)
+// Item types of a rucksack, with bit p - 1 set for priority p
+static std::uint_fast64_t item_set(const std::string_view rucksack) noexcept
 {
-	const int p = item_priority(t);
-	if (p < 0) {
-		std::ostringstream s;
-		s << "Wrong item type '" << t << '\'';
-		throw std::invalid_argument(s.str());
-	}
-	present[group] |= std::uint_fast64_t{1} << (p - 1);
+	std::uint_fast64_t set = 0;
+	for (const char t : rucksack)
+		set |= std::uint_fast64_t{1} << (item_priority(t) - 1);
+	return set;
 }
 
-constexpr std::uintmax_t parser::group_badge() const
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in);
+	puzzle_output part1() override;
+	puzzle_output part2() override;
+
+private:
+	// Whole groups of three, with valid items and halves of the same size
+	std::vector<std::string> rucksacks{};
+};
+
+solution::solution(std::istream& in)
 {
-	std::size_t result = 127;
-	for (std::size_t i = 0; i < 52; ++i) {
-		const auto p = [i](const std::uint_fast64_t x) {
-			return (x & std::uint_fast64_t{1} << i) != 0;
-		};
-		if (std::all_of(std::cbegin(present), std::cend(present), p)) {
-			if (result < 127)
-				throw std::runtime_error("Bad group");
-			result = i;
+	const auto parse_error = [this] {
+		std::ostringstream s;
+		s << "Error while parsing rucksack " << (rucksacks.size() + 1);
+		return std::runtime_error(s.str());
+	};
+	std::string rucksack;
+	while (in >> rucksack) {
+		if (std::size(rucksack) % 2 != 0) [[unlikely]]
+			throw parse_error();
+		for (const char t : rucksack) {
+			if (item_priority(t) < 0) [[unlikely]] {
+				std::ostringstream s;
+				s << "Wrong item type '" << t << '\'';
+				throw std::invalid_argument(s.str());
+			}
 		}
+		rucksacks.push_back(std::move(rucksack));
 	}
-	if (result >= 52)
-		throw std::runtime_error("No group badge found");
-	return result + 1;
+	if (!in.eof()) [[unlikely]]
+		throw parse_error();
+	else if (rucksacks.size() % 3 != 0) [[unlikely]]
+		throw std::runtime_error("Rucksacks can't be grouped by 3");
 }
 
-static std::istream& operator>>(std::istream& in, parser& p)
+puzzle_output solution::part1()
 {
-	std::string rucksack;
-	if (!(in >> rucksack))
-		return in;
-	if (std::size(rucksack) % 2 != 0) [[unlikely]] {
-		in.setstate(std::ios_base::failbit);
-		return in;
-	}
-	for (const char t : rucksack)
-		p.visit_item(t);
-	p.sum_priority += common_priority(std::move(rucksack));
-	++p.group;
-	if (p.group == 3) {
-		p.sum_badges += p.group_badge();
-		std::fill(std::execution::unseq, std::begin(p.present),
-		          std::end(p.present), std::uint_fast64_t{0});
-		p.group = 0;
+	std::uintmax_t sum = 0;
+	for (const std::string& r : rucksacks)
+		sum += common_priority(r);
+	return sum;
+}
+
+// The badge of a group is the only item type all three of them carry
+puzzle_output solution::part2()
+{
+	std::uintmax_t sum = 0;
+	for (auto it = rucksacks.cbegin(); it != rucksacks.cend(); it += 3) {
+		const std::uint_fast64_t common =
+			item_set(it[0]) & item_set(it[1]) & item_set(it[2]);
+		if (common == 0) [[unlikely]]
+			throw std::runtime_error("No group badge found");
+		if (!std::has_single_bit(common)) [[unlikely]]
+			throw std::runtime_error("Bad group");
+		sum += static_cast<std::uintmax_t>(std::countr_zero(common)) + 1;
 	}
-	return in;
+	return sum;
 }
 
 }
 
-template<> output_pair day<3>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<3>(std::istream& in)
 {
-	parser p;
-	std::uintmax_t n = 1;
-	while (in >> p)
-		++n;
-	if (!in.eof()) [[unlikely]] {
-		std::ostringstream s;
-		s << "Error while parsing rucksack " << n;
-		throw std::runtime_error(s.str());
-	} else if (!p) [[unlikely]] {
-		throw std::runtime_error("Rucksacks can't be grouped by 3");
-	}
-	return {p.priority(), p.badges()};
+	return std::make_unique<solution>(in);
 }
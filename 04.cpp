@@ -1,39 +1,75 @@
+#include <algorithm>
 #include <cstdint>
-#include <ios>
-#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "common.h"
+#include "cursor.h"
 #include "interval.h"
 
 using interval_type = interval<std::uintmax_t>;
 
-static std::istream& operator>>(std::istream& i, interval_type& x)
+static bool read_interval(cursor& c, interval_type& x)
 {
 	std::uintmax_t a, b;
-	if (i >> a && i.get() == '-' && i >> b)
-		x = interval{a, b};
-	else
-		i.setstate(std::ios_base::failbit);
-	return i;
+	if (!c.read_uint(a) || !c.expect('-') || !c.read_uint(b))
+		return false;
+	x = interval{a, b};
+	return true;
 }
 
-template<> output_pair day<4>(std::istream& in)
+namespace {
+
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in);
+	puzzle_output part1() override;
+	puzzle_output part2() override;
+
+private:
+	std::vector<std::pair<interval_type, interval_type>> pairs{};
+};
+
+solution::solution(const std::string_view in)
 {
+	cursor c{in};
 	interval_type a;
 	interval_type b;
-	std::uintmax_t count_contains = 0;
-	std::uintmax_t count_overlap = 0;
-	while (in >> a && in.get() == ',' && in >> b) {
-		switch (interval_type::compare(a, b)) {
-		default: break;
-		case interval_type::relation::contained:
-			++count_contains;
-			[[fallthrough]];
-		case interval_type::relation::overlap:
-			++count_overlap;
-		}
+	for (c.skip_ws(); !c.empty(); c.skip_ws()) {
+		if (!read_interval(c, a) || !c.expect(',')
+		    || !read_interval(c, b)) [[unlikely]]
+			throw std::runtime_error("Error while reading puzzle input");
+		pairs.emplace_back(a, b);
 	}
-	if (!in.eof())
-		throw std::runtime_error("Error while reading puzzle input");
-	return {count_contains, count_overlap};
+}
+
+// Pairs where one section range contains the other
+puzzle_output solution::part1()
+{
+	return static_cast<std::uintmax_t>(std::count_if(
+		pairs.cbegin(), pairs.cend(), [](const auto& p) {
+			return interval_type::compare(p.first, p.second)
+			       == interval_type::relation::contained;
+		}));
+}
+
+// Pairs whose ranges overlap at all, containing ones included
+puzzle_output solution::part2()
+{
+	return static_cast<std::uintmax_t>(std::count_if(
+		pairs.cbegin(), pairs.cend(), [](const auto& p) {
+			const auto r = interval_type::compare(p.first, p.second);
+			return r == interval_type::relation::contained
+			       || r == interval_type::relation::overlap;
+		}));
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<4>(std::string_view in)
+{
+	return std::make_unique<solution>(in);
 }
@@ -4,6 +4,7 @@
 #include <istream>
 #include <limits>
 #include <locale>
+#include <memory>
 #include <span>
 #include <sstream>
 #include <stdexcept>
@@ -149,13 +150,29 @@ move_crates_id(std::vector<std::vector<char>> stacks,
 	return move_crates(std::move(stacks), instructions, m);
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in)
+		: stacks{parse_crates(in)}
+		, instructions{parse_instructions(in)}
+	{}
+
+	puzzle_output part1() override {
+		return read_top(move_crates_rev(stacks, instructions));
+	}
+
+	puzzle_output part2() override {
+		return read_top(move_crates_id(stacks, instructions));
+	}
+
+private:
+	std::vector<std::vector<char>> stacks;
+	std::vector<instruction> instructions;
+};
+
 }
 
-template<> output_pair day<5>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<5>(std::istream& in)
 {
-	std::vector<std::vector<char>> state9000 = parse_crates(in);
-	std::vector<std::vector<char>> state9001 = state9000;
-	std::vector<instruction> instructions = parse_instructions(in);
-	return {read_top(move_crates_rev(std::move(state9000), instructions)),
-	        read_top(move_crates_id(std::move(state9001), instructions))};
+	return std::make_unique<solution>(in);
 }
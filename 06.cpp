@@ -1,9 +1,10 @@
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <execution>
-#include <istream>
-#include <span>
-#include <string>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
 
 #include "common.h"
 
@@ -18,44 +19,31 @@ template<class Iter> constexpr bool has_repeat(Iter begin, Iter end) noexcept
 	return false;
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : datastream{next_line(in)} {}
+	puzzle_output part1() override { return find_marker(4); }
+	puzzle_output part2() override { return find_marker(14); }
+
+private:
+	[[nodiscard]] std::uintmax_t find_marker(std::size_t length) const;
+
+	std::string_view datastream;
+};
 
-[[noreturn]] static void fail_on_input(const std::istream& in)
+std::uintmax_t solution::find_marker(const std::size_t length) const
 {
-	if (in.eof())
-		throw std::runtime_error("The puzzle input is too short");
-	throw std::runtime_error("Error while reading the puzzle input");
+	for (std::size_t end = length; end <= datastream.size(); ++end) {
+		const auto it = datastream.cbegin() + end;
+		if (!has_repeat(it - length, it))
+			return end;
+	}
+	throw std::runtime_error("The puzzle input is too short");
 }
 
-static void extract_character(std::istream& in, std::span<char, 14> buf)
-{
-	std::shift_left(buf.begin(), buf.end(), 1);
-	const std::istream::int_type next = in.get();
-	if (next == std::istream::traits_type::eof()) [[unlikely]]
-		fail_on_input(in);
-	buf.back() = std::istream::traits_type::to_char_type(next);
 }
 
-template<> output_pair day<6>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<6>(std::string_view in)
 {
-	char buf[14];
-	std::uintmax_t packet = 4;
-	if (!in.read(buf, 14))
-		fail_on_input(in);
-	for (auto it = std::cbegin(buf);
-	     it + 3 != std::cend(buf) && has_repeat(it, it + 4);
-	     ++it, ++packet);
-	if (packet == 15) {
-		--packet;
-		do {
-			extract_character(in, buf);
-			++packet;
-		} while (has_repeat(std::cend(buf) - 4, std::cend(buf)));
-	}
-	std::uintmax_t message = packet;
-	do {
-		extract_character(in, buf);
-		++message;
-	} while (has_repeat(std::cbegin(buf), std::cend(buf)));
-	return {packet, message};
+	return std::make_unique<solution>(in);
 }
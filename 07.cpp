@@ -246,15 +246,39 @@ static std::vector<std::uintmax_t> directory_sizes(directory& dir)
 	return result;
 }
 
-template<> output_pair day<7>(std::istream& in)
+namespace {
+
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in)
+		: root{in}
+		, sizes{directory_sizes(root)}
+	{}
+
+	puzzle_output part1() override {
+		const auto a = std::upper_bound(sizes.cbegin(), sizes.cend(),
+		                                100000);
+		return std::accumulate(sizes.cbegin(), a, std::uintmax_t{0});
+	}
+
+	puzzle_output part2() override {
+		const std::uintmax_t free_space = 70000000 - sizes.back();
+		const std::uintmax_t to_free = 30000000 - free_space;
+		const auto b = std::lower_bound(sizes.cbegin(), sizes.cend(),
+		                                to_free);
+		if (b == sizes.cend()) [[unlikely]]
+			throw std::runtime_error("Cannot free enough space");
+		return *b;
+	}
+
+private:
+	directory root;
+	std::vector<std::uintmax_t> sizes;
+};
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<7>(std::istream& in)
 {
-	directory dir{in};
-	const auto sizes = directory_sizes(dir);
-	const auto a = std::upper_bound(sizes.cbegin(), sizes.cend(), 100000);
-	const std::uintmax_t free_space = 70000000 - sizes.back();
-	const std::uintmax_t to_free = 30000000 - free_space;
-	const auto b = std::lower_bound(sizes.cbegin(), sizes.cend(), to_free);
-	if (b == sizes.cend()) [[unlikely]]
-		throw std::runtime_error("Cannot free enough space");
-	return {std::accumulate(sizes.cbegin(), a, 0), *b};
+	return std::make_unique<solution>(in);
 }
@@ -3,11 +3,14 @@
 #include <cstdint>
 #include <execution>
 #include <istream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "common.h"
+#include "grid.h"
 
 static bool is_digits(const std::string& s) noexcept
 {
@@ -23,8 +26,8 @@ public:
 		if (!std::getline(in, line) || !is_digits(line)) [[unlikely]]
 			throw std::runtime_error("Puzzle input error");
 		std::vector<char> dat(line.cbegin(), line.cend());
-		width = line.size();
-		height = 1;
+		const std::size_t width = line.size();
+		std::size_t height = 1;
 		while (std::getline(in, line) && is_digits(line)) {
 			if (line.empty())
 				continue;
@@ -38,68 +41,53 @@ public:
 			throw std::runtime_error("Puzzle input error");
 		if (width > static_cast<std::size_t>(limits::max()) / height)
 			throw std::runtime_error("Forest is too big");
-		data = std::make_unique<char[]>(width * height);
-		std::copy(std::execution::unseq, dat.cbegin(), dat.cend(),
-		          data.get());
+		trees = grid<char>{width, height, border};
+		for (std::size_t r = 0; r < height; ++r) {
+			const auto row = trees.row(static_cast<index>(r));
+			std::copy_n(dat.cbegin() + r * width, width, row.begin());
+		}
 	}
 
+	// Trees on the edge are visible since nothing is lower than them
 	[[nodiscard]] std::size_t count_visible_trees() const {
-		const std::size_t area = width * height;
-		std::unique_ptr<bool[]> visible =
-			std::make_unique<bool[]>(area);
-		std::fill(std::execution::unseq, visible.get(),
-		          visible.get() + width, true);
-		for (std::size_t r = 1; r + 1 < height; ++r) {
-			visible[width * r] = true;
-			std::fill(std::execution::unseq,
-			          visible.get() + width * r + 1,
-			          visible.get() + width * (r + 1) - 1, false);
-			visible[width * r + width - 1] = true;
-		}
-		std::fill(std::execution::unseq,
-		          visible.get() + (height - 1) * width,
-		          visible.get() + area, true);
-		for (std::size_t r = 1; r + 1 < height; ++r) {
-			char m = data[r * width];
-			for (std::size_t c = 1; c < width; ++c) {
-				if (data[r * width + c] > m) {
-					visible[r * width + c] = true;
-					m = data[r * width + c];
-				}
-			}
-			m = data[r * width + width - 1];
-			for (std::size_t c = width - 1; c > 0; --c) {
-				if (data[r * width + c - 1] > m) {
-					visible[r * width + c - 1] = true;
-					m = data[r * width + c - 1];
+		grid<bool> visible{trees.width(), trees.height(), false};
+		const auto mark = [](const auto& line, const auto& seen,
+		                     const bool backwards) {
+			char m = '0' - 1;
+			const std::size_t n = line.size();
+			for (std::size_t i = 0; i < n; ++i) {
+				const std::size_t k = backwards ? n - 1 - i : i;
+				if (line[k] > m) {
+					seen[k] = true;
+					m = line[k];
 				}
 			}
+		};
+		for (index r = 0; r < static_cast<index>(trees.height()); ++r) {
+			mark(trees.row(r), visible.row(r), false);
+			mark(trees.row(r), visible.row(r), true);
 		}
-		for (std::size_t c = 1; c + 1 < width; ++c) {
-			char m = data[c];
-			for (std::size_t r = 1; r < height; ++r) {
-				if (data[r * width + c] > m) {
-					visible[r * width + c] = true;
-					m = data[r * width + c];
-				}
-			}
-			m = data[(height - 1) * width + c];
-			for (std::size_t r = height - 1; r > 0; --r) {
-				if (data[(r - 1) * width + c] > m) {
-					visible[(r - 1) * width + c] = true;
-					m = data[(r - 1) * width + c];
-				}
-			}
+		for (index c = 0; c < static_cast<index>(trees.width()); ++c) {
+			mark(trees.column(c), visible.column(c), false);
+			mark(trees.column(c), visible.column(c), true);
 		}
-		return std::count(std::execution::unseq, visible.get(),
-				  visible.get() + width * height, true);
+		std::size_t count = 0;
+		for (index r = 0; r < static_cast<index>(trees.height()); ++r) {
+			const auto row = visible.row(r);
+			count += std::count(row.begin(), row.end(), true);
+		}
+		return count;
 	}
 
 	[[nodiscard]] std::uintmax_t max_scenic_score() const noexcept {
 		std::uintmax_t acc = 0;
-		for (std::size_t r = 1; r + 1 < height; ++r) {
-			for (std::size_t c = 1; c + 1 < width; ++c) {
-				const std::uintmax_t s = scenic_score(r, c);
+		const auto w = static_cast<index>(trees.width());
+		const auto h = static_cast<index>(trees.height());
+		for (index r = 1; r + 1 < h; ++r) {
+			for (index c = 1; c + 1 < w; ++c) {
+				const std::uintmax_t s = scenic_score(
+					trees.index(c, r)
+				);
 				if (s > acc)
 					acc = s;
 			}
@@ -108,35 +96,46 @@ public:
 	}
 
 private:
-	[[nodiscard]] std::uintmax_t
-	scenic_score(const std::size_t r, const std::size_t c) const noexcept {
-		const char t = data[r * width + c];
-		std::uintmax_t d_left = 1;
-		for (std::size_t x = c - 1;
-		     x > 0 && data[r * width + x] < t; --x)
-			++d_left;
-		std::uintmax_t d_right = 1;
-		for (std::size_t x = c + 1;
-		     x + 1 < width && data[r * width + x] < t; ++x)
-			++d_right;
-		std::uintmax_t d_up = 1;
-		for (std::size_t y = r - 1; y > 0 && data[y * width + c] < t;
-		     --y)
-			++d_up;
-		std::uintmax_t d_down = 1;
-		for (std::size_t y = r + 1;
-		     y + 1 < height && data[y * width + c] < t; ++y)
-			++d_down;
-		return d_up * d_down * d_left * d_right;
+	using index = grid<char>::index_type;
+
+	// Higher than any tree, so that looking stops at the border
+	static constexpr char border = '9' + 1;
+
+	[[nodiscard]] std::uintmax_t scenic_score(const index i) const noexcept
+	{
+		const char t = trees[i];
+		std::uintmax_t score = 1;
+		for (const index d : trees.neighbors()) {
+			std::uintmax_t distance = 0;
+			index j = i;
+			do {
+				j += d;
+				++distance;
+			} while (trees[j] < t);
+			// The border is not a tree
+			score *= distance - (trees[j] == border);
+		}
+		return score;
 	}
 
-	std::unique_ptr<char[]> data = nullptr;
-	std::size_t width = 0;
-	std::size_t height = 0;
+	grid<char> trees{};
+};
+
+namespace {
+
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : f{in} {}
+	puzzle_output part1() override { return f.count_visible_trees(); }
+	puzzle_output part2() override { return f.max_scenic_score(); }
+
+private:
+	forest f;
 };
 
-template<> output_pair day<8>(std::istream& in)
+}
+
+template<> std::unique_ptr<parsed_input> parse<8>(std::istream& in)
 {
-	const forest f{in};
-	return {f.count_visible_trees(), f.max_scenic_score()};
+	return std::make_unique<solution>(in);
 }
@@ -1,46 +1,50 @@
 #include <algorithm>
 #include <cinttypes>
+#include <cstddef>
 #include <execution>
 #include <istream>
 #include <limits>
-#include <set>
+#include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "common.h"
+#include "flat_hash.h"
 
 namespace {
 
+struct motion {
+	std::intmax_t direction;
+	std::intmax_t amount;
+};
+
 class rope {
-	friend std::istream& operator>>(std::istream&, rope&);
 public:
-	std::uintmax_t count_tail_positions_short() const noexcept {
-		return visited_1.size();
-	}
+	explicit rope(const std::size_t knots) : segments(knots, {0, 0}) {}
+	void move(const motion& m);
 
-	std::uintmax_t count_tail_positions_long() const noexcept {
-		return visited_9.size();
+	std::uintmax_t count_tail_positions() const noexcept {
+		return visited.size();
 	}
 
 private:
 	struct coord {
-		std::strong_ordering operator<=>(const coord&) const noexcept
-			= default;
+		bool operator==(const coord&) const noexcept = default;
 
 		std::intmax_t x;
 		std::intmax_t y;
 	};
 
-	bool drag(unsigned int n);
+	bool drag(std::size_t n);
 
-	coord segments[10]{{0, 0}};
-	std::set<coord> visited_1{{0, 0}};
-	std::set<coord> visited_9{{0, 0}};
+	std::vector<coord> segments;
+	// Slots come from the arena; those outgrown are few next to the last
+	flat_hash_set<coord> visited{{coord{0, 0}}, day_arena()};
 };
 
-std::istream& operator>>(std::istream& in, rope& r)
+std::istream& operator>>(std::istream& in, motion& m)
 {
-	using limits = std::numeric_limits<std::intmax_t>;
 	constexpr const char directions[] = {'U', 'D', 'L', 'R'};
 	std::istream::int_type c;
 	while ((c = in.get()) == in.widen('\n'));
@@ -52,38 +56,40 @@ std::istream& operator>>(std::istream& in, rope& r)
 	                           std::istream::traits_type::to_char_type(c));
 	if (dir == std::end(directions)) [[unlikely]]
 		throw std::runtime_error("Invalid direction");
-	auto div_result = std::imaxdiv(dir - std::begin(directions), 2);
-	std::intmax_t amount;
-	if (!(in >> amount)) [[unlikely]] {
+	m.direction = dir - std::begin(directions);
+	if (!(in >> m.amount)) [[unlikely]] {
 		in.setstate(std::ios_base::failbit);
 		return in;
 	}
-	if (amount < 0) [[unlikely]]
+	if (m.amount < 0) [[unlikely]]
 		throw std::runtime_error("Moving by a negative amount");
-	std::intmax_t& z = div_result.quot ? r.segments[0].x : r.segments[0].y;
+	return in;
+}
+
+void rope::move(const motion& m)
+{
+	using limits = std::numeric_limits<std::intmax_t>;
+	auto div_result = std::imaxdiv(m.direction, 2);
+	std::intmax_t& z = div_result.quot ? segments[0].x : segments[0].y;
 	if (div_result.rem == 1
-	    && limits::max() - 1 - amount < z) [[unlikely]] {
+	    && limits::max() - 1 - m.amount < z) [[unlikely]] {
 		throw std::runtime_error("Integer overflow detected");
 	} else if (div_result.rem == 0
-	           && limits::min() + 1 + amount > z) [[unlikely]] {
+	           && limits::min() + 1 + m.amount > z) [[unlikely]] {
 		throw std::runtime_error("Integer overflow detected");
 	}
-	for (std::intmax_t a = 0; a < amount; ++a) {
+	for (std::intmax_t a = 0; a < m.amount; ++a) {
 		z += div_result.rem ? 1 : -1;
-		for (unsigned int n = 1; n < 10; ++n) {
-			if (r.drag(n)) {
-				if (n == 1)
-					r.visited_1.insert(r.segments[n]);
-				else if (n == 9) {
-					r.visited_9.insert(r.segments[n]);
-				}
-			}
+		for (std::size_t n = 1; n < segments.size(); ++n) {
+			if (!drag(n))
+				break;
+			if (n + 1 == segments.size())
+				visited.insert(segments[n]);
 		}
 	}
-	return in;
 }
 
-bool rope::drag(unsigned int n)
+bool rope::drag(std::size_t n)
 {
 	auto& [hx, hy] = segments[n - 1];
 	auto& [tx, ty] = segments[n];
@@ -119,13 +125,38 @@ bool rope::drag(unsigned int n)
 	return false;
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in);
+	puzzle_output part1() override { return simulate(2); }
+	puzzle_output part2() override { return simulate(10); }
+
+private:
+	[[nodiscard]] std::uintmax_t simulate(std::size_t knots) const;
 
-template<> output_pair day<9>(std::istream& in)
+	std::vector<motion> motions{};
+};
+
+solution::solution(std::istream& in)
 {
-	rope r;
-	while (in >> r);
+	motion m;
+	while (in >> m)
+		motions.push_back(m);
 	if (!in.eof()) [[unlikely]]
 		throw std::runtime_error("Error while reading puzzle input");
-	return {r.count_tail_positions_short(), r.count_tail_positions_long()};
+}
+
+std::uintmax_t solution::simulate(const std::size_t knots) const
+{
+	rope r{knots};
+	for (const motion& m : motions)
+		r.move(m);
+	return r.count_tail_positions();
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<9>(std::istream& in)
+{
+	return std::make_unique<solution>(in);
 }
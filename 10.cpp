@@ -3,6 +3,7 @@
 #include <execution>
 #include <istream>
 #include <limits>
+#include <memory>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -86,16 +87,34 @@ void cpu::inspect_tick()
 		screen += '\n';
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in);
+	puzzle_output part1() override;
+	puzzle_output part2() override { return c.display(); }
 
-template<> output_pair day<10>(std::istream& in)
+private:
+	cpu c{};
+};
+
+solution::solution(std::istream& in)
 {
-	cpu c;
 	while (in >> c);
 	if (!in.eof())
 		throw std::runtime_error("Error while reading puzzle input");
+}
+
+puzzle_output solution::part1()
+{
 	const std::intmax_t s = c.strengths();
 	if (s < 0)
 		throw std::runtime_error("Negative signal strength sum");
-	return {static_cast<std::uintmax_t>(s), c.display()};
+	return static_cast<std::uintmax_t>(s);
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<10>(std::istream& in)
+{
+	return std::make_unique<solution>(in);
 }
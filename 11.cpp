@@ -1,16 +1,18 @@
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
 #include <execution>
-#include <ios>
-#include <istream>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
+#include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include "common.h"
-#include "read.h"
+#include "scan.h"
 
 enum class operation { add, multiply };
 
@@ -27,7 +29,7 @@ struct monkey {
 
 class monkey_circle {
 public:
-	explicit monkey_circle(std::istream& in);
+	explicit monkey_circle(std::string_view in);
 	void run_round(bool calm_down);
 
 	[[nodiscard]] std::uintmax_t monkey_business() const noexcept {
@@ -48,71 +50,54 @@ private:
 	std::uintmax_t product_tests = 1;
 };
 
-static std::istream& operator>>(std::istream& in, monkey& m)
+// An operand of "old" is stored as the largest value
+static std::uintmax_t read_operand(const std::string_view w)
 {
-	using namespace std::literals;
-	using limits = std::numeric_limits<std::streamsize>;
-	while (in.peek() == in.widen('\n'))
-		in.ignore();
-	if (!read_expect(in, "Monkey"sv)
-	    || !in.ignore(limits::max(), in.widen('\n'))
-	    || !read_expect(in, "  Starting items:"sv)) [[unlikely]]
-		return in;
-	m.items.clear();
+	if (w == "old")
+		return std::numeric_limits<std::uintmax_t>::max();
+	std::uintmax_t x;
+	const auto [end, ec] = std::from_chars(w.data(), w.data() + w.size(), x);
+	if (ec != std::errc{} || end != w.data() + w.size()) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	return x;
+}
+
+static monkey read_monkey(std::string_view& in)
+{
+	monkey m;
+	std::size_t id;
+	if (!scan<" Monkey {}: Starting items:">(in, id)) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
 	std::uintmax_t item;
-	if (in.peek() != in.widen('\n')) {
-		if (!(in >> item)) [[unlikely]]
-			return in;
+	if (scan<" {}">(in, item)) {
 		m.items.push_back(item);
-		while (in.peek() == in.widen(',')) {
-			in.ignore();
-			if (!(in >> item))
-				return in;
+		while (scan<", {}">(in, item))
 			m.items.push_back(item);
-		}
-		if (in.get() != in.widen('\n')) {
-			in.setstate(std::ios_base::failbit);
-			m.items.clear();
-			return in;
-		}
 	}
 	m.items.shrink_to_fit();
-	if (!read_expect(in, "  Operation: new = old "sv))
-		return in;
-	const int c = in.get();
-	if (c == in.widen('+')) {
+	char op;
+	std::string_view operand;
+	if (!scan<" Operation: new = old {} {}"
+	          " Test: divisible by {}"
+	          " If true: throw to monkey {}"
+	          " If false: throw to monkey {}">(
+		in, op, operand, m.test, m.throw_to[1], m.throw_to[0]))
+		[[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	if (op == '+')
 		m.op = operation::add;
-	} else if (c == in.widen('*')) {
+	else if (op == '*')
 		m.op = operation::multiply;
-	} else [[unlikely]] {
-		in.setstate(std::ios_base::failbit);
-		return in;
-	}
-	while (in.peek() == in.widen(' '))
-		in.ignore();
-	if (!(in >> m.operand)) {
-		in.clear();
-		if (!read_expect(in, "old"sv))
-			return in;
-		m.operand = std::numeric_limits<std::uintmax_t>::max();
-	}
-	if (!in.ignore(limits::max(), in.widen('\n'))
-	    || !read_expect(in, "  Test: divisible by"sv) >> m.test
-	    || !(in >> m.test).ignore(limits::max(), in.widen('\n'))
-	    || !read_expect(in, "    If true: throw to monkey"sv)
-	    || !(in >> m.throw_to[1]).ignore(limits::max(), in.widen('\n'))
-	    || !read_expect(in, "    If false: throw to monkey"sv))
-		return in;
-	return in >> m.throw_to[0];
+	else [[unlikely]]
+		throw std::runtime_error("Unknown operation");
+	m.operand = read_operand(operand);
+	return m;
 }
 
-monkey_circle::monkey_circle(std::istream& in)
+monkey_circle::monkey_circle(std::string_view in)
 {
-	monkey m;
-	while (in >> m)
-		monkeys.emplace_back(std::move(m));
-	if (!in.eof()) [[unlikely]]
-		throw std::runtime_error("Error while reading puzzle input");
+	while (in.find_first_not_of(" \n") != in.npos)
+		monkeys.push_back(read_monkey(in));
 	for (std::size_t i = 0; i < monkeys.size(); ++i) {
 		const auto p = [this, i](std::size_t to) {
 			return to == i || to >= std::size(monkeys);
@@ -151,15 +136,27 @@ void monkey_circle::run_round(const bool calm_down)
 	}
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : circle{in} {}
+	puzzle_output part1() override { return simulate(20, true); }
+	puzzle_output part2() override { return simulate(10000, false); }
+
+private:
+	[[nodiscard]] std::uintmax_t
+	simulate(const int rounds, const bool calm_down) const {
+		monkey_circle c = circle;
+		for (int r = 0; r < rounds; ++r)
+			c.run_round(calm_down);
+		return c.monkey_business();
+	}
+
+	monkey_circle circle;
+};
+
 }
 
-template<> output_pair day<11>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<11>(std::string_view in)
 {
-	monkey_circle circle_1{in};
-	monkey_circle circle_2 = circle_1;
-	for (int r = 0; r < 20; ++r)
-		circle_1.run_round(true);
-	for (int r = 0; r < 10000; ++r)
-		circle_2.run_round(false);
-	return {circle_1.monkey_business(), circle_2.monkey_business()};
+	return std::make_unique<solution>(in);
 }
@@ -1,12 +1,15 @@
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <execution>
 #include <istream>
+#include <memory>
 #include <optional>
 #include <stdexcept>
-#include <utility>
 #include <vector>
 
+#include "bit_grid.h"
 #include "common.h"
 
 namespace {
@@ -14,25 +17,39 @@ namespace {
 class hill_map {
 public:
 	explicit hill_map(std::istream& in);
-	std::pair<std::uintmax_t, std::uintmax_t> get_distances() const;
+
+	[[nodiscard]] std::uintmax_t distance_from_start() const {
+		return distance_to([this](const bit_grid& f) {
+			return f.intersects(start);
+		});
+	}
+
+	[[nodiscard]] std::uintmax_t distance_from_lowest() const {
+		return distance_to([this](const bit_grid& f) {
+			return f.intersects(heights.front());
+		});
+	}
 
 private:
-	using size_type = std::vector<unsigned char>::size_type;
+	template<class P>
+	[[nodiscard]] std::uintmax_t distance_to(const P& is_target) const;
 
-	std::vector<unsigned char> map{};
-	size_type width = 0;
-	size_type start{};
-	size_type goal{};
+	// Cells of each height
+	std::array<bit_grid, 26> heights{};
+	bit_grid start{};
+	bit_grid goal{};
 };
 
 hill_map::hill_map(std::istream& in)
 {
 	constexpr char a[] = "abcdefghijklmnopqrstuvwxyz";
 	std::istream::int_type c;
-	size_type x = 0;
-	bool set_start = false;
-	bool set_goal = false;
-	const auto check_width = [this, &x] {
+	std::vector<unsigned char> map;
+	std::vector<unsigned char>::size_type width = 0;
+	std::vector<unsigned char>::size_type x = 0;
+	std::optional<std::size_t> set_start;
+	std::optional<std::size_t> set_goal;
+	const auto check_width = [&width, &x] {
 		if (width != 0 && x > width)
 			throw std::runtime_error("Inconsistent width");
 	};
@@ -47,14 +64,12 @@ hill_map::hill_map(std::istream& in)
 			x = 0;
 		} else if (c == 'S') {
 			check_width();
-			set_start = true;
-			start = map.size();
+			set_start = map.size();
 			map.push_back(0);
 			++x;
 		} else if (c == 'E') {
 			check_width();
-			set_goal = true;
-			goal = map.size();
+			set_goal = map.size();
 			map.push_back(25);
 			++x;
 		} else {
@@ -78,62 +93,73 @@ hill_map::hill_map(std::istream& in)
 		width = map.size();
 	else if (map.size() % width != 0)
 		throw std::runtime_error("Inconstistent width");
+	const bit_grid empty{width, map.size() / width};
+	heights.fill(empty);
+	for (std::size_t i = 0; i < map.size(); ++i)
+		heights[map[i]].set(i % width, i / width);
+	start = empty;
+	start.set(*set_start % width, *set_start / width);
+	goal = empty;
+	goal.set(*set_goal % width, *set_goal / width);
 }
 
-std::pair<std::uintmax_t, std::uintmax_t> hill_map::get_distances() const
+/*
+ * The search goes backwards from the goal: a cell of height h is reached from
+ * the neighbors in the frontier of height at most h + 1. Spreading is linear,
+ * so those neighbors are accumulated going up the heights, and only heights
+ * present in the frontier are spread.
+ */
+template<class P>
+std::uintmax_t hill_map::distance_to(const P& is_target) const
 {
-	using frontier_type = std::vector<size_type>;
-	std::vector<bool> explored(map.size(), false);
-	explored[goal] = true;
-	frontier_type frontier;
-	frontier_type next_frontier;
-	const auto add_neighbors =
-		[this, &explored](frontier_type& to, size_type i) {
-			const unsigned char t = map[i] - 1;
-			size_type n = i - width;
-			const auto add_n = [&n, &explored, &to] {
-				explored[n] = true;
-				to.push_back(n);
+	bit_search<bit_grid> search{goal};
+	bit_grid part{goal};
+	bit_grid spread{goal};
+	bit_grid reach{goal};
+	const auto climb_down =
+		[this, &part, &spread, &reach](bit_grid& next,
+		                               const bit_grid& frontier) {
+			const auto reach_from = [&](const std::size_t h) {
+				part = frontier;
+				part &= heights[h];
+				if (part.any()) {
+					spread.spread(part);
+					reach |= spread;
+				}
 			};
-			if (i > width && !explored[n] && map[n] >= t)
-				add_n();
-			n = i + width;
-			if (map.size() - width > i && !explored[n]
-			    && map[n] >= t)
-				add_n();
-			n = i - 1;
-			if (i % width > 0 && !explored[n] && map[n] >= t)
-				add_n();
-			n = i + 1;
-			if (i % width < width - 1 && !explored[n]
-			    && map[n] >= t)
-				add_n();
+			next.clear();
+			reach.clear();
+			reach_from(0);
+			for (std::size_t h = 0; h < heights.size(); ++h) {
+				if (h + 1 < heights.size())
+					reach_from(h + 1);
+				part = heights[h];
+				part &= reach;
+				next |= part;
+			}
 		};
-	add_neighbors(frontier, goal);
-	std::optional<std::uintmax_t> opt_start;
-	std::optional<std::uintmax_t> opt_any;
 	std::uintmax_t distance = 0;
-	while (!frontier.empty()) [[likely]] {
+	while (search.expand(climb_down)) [[likely]] {
 		++distance;
-		for (size_type i : frontier) {
-			if (i == start)
-				opt_start = distance;
-			if (!opt_any && map[i] == 0)
-				opt_any = distance;
-			if (opt_start && opt_any)
-				return {*opt_start, *opt_any};
-			add_neighbors(next_frontier, i);
-		}
-		frontier = std::move(next_frontier);
+		if (is_target(search.frontier()))
+			return distance;
 	}
 	throw std::logic_error("No path was found");
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : m{in} {}
+	puzzle_output part1() override { return m.distance_from_start(); }
+	puzzle_output part2() override { return m.distance_from_lowest(); }
+
+private:
+	hill_map m;
+};
+
 }
 
-template<> output_pair day<12>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<12>(std::istream& in)
 {
-	const hill_map m{in};
-	auto [start, any] = m.get_distances();
-	return {std::move(start), std::move(any)};
+	return std::make_unique<solution>(in);
 }
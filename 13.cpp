@@ -1,6 +1,5 @@
-#include <algorithm>
+#include <cstddef>
 #include <cstdint>
-#include <execution>
 #include <ios>
 #include <istream>
 #include <memory>
@@ -146,30 +145,57 @@ value value::separation_packet(const std::uintmax_t n)
 	return value{std::move(outer)};
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in);
+	puzzle_output part1() override;
+	puzzle_output part2() override;
 
-template<> output_pair day<13>(std::istream& in)
+private:
+	std::vector<value> packets{};
+};
+
+solution::solution(std::istream& in)
 {
-	std::uintmax_t index = 1;
-	std::uintmax_t sum = 0;
-	std::vector<value> packets;
 	while (in) {
 		packets.emplace_back(in);
 		packets.emplace_back(in);
-		if (packets[packets.size() - 2] <= packets.back())
-			sum += index;
 		while (in.peek() == '\n')
 			in.ignore();
 		if (in.peek() == std::istream::traits_type::eof())
 			break;
-		++index;
 	}
+}
+
+puzzle_output solution::part1()
+{
+	std::uintmax_t sum = 0;
+	for (std::size_t i = 0; i + 1 < packets.size(); i += 2) {
+		if (packets[i] <= packets[i + 1])
+			sum += i / 2 + 1;
+	}
+	return sum;
+}
+
+// Positions the separation packets would have if inserted and sorted
+puzzle_output solution::part2()
+{
 	const value a = value::separation_packet(2);
 	const value b = value::separation_packet(6);
-	packets.emplace_back(a);
-	packets.emplace_back(b);
-	std::sort(std::execution::unseq, packets.begin(), packets.end());
-	const auto i = std::lower_bound(packets.cbegin(), packets.cend(), a);
-	const auto j = std::lower_bound(packets.cbegin(), packets.cend(), b);
-	return {sum, (i - packets.cbegin() + 1) * (j - packets.cbegin() + 1)};
+	std::uintmax_t i = 1;
+	std::uintmax_t j = 2;
+	for (const value& p : packets) {
+		if (p < a)
+			++i;
+		if (p < b)
+			++j;
+	}
+	return i * j;
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<13>(std::istream& in)
+{
+	return std::make_unique<solution>(in);
 }
@@ -1,14 +1,14 @@
 #include <algorithm>
 #include <cstdint>
-#include <execution>
-#include <ios>
-#include <istream>
 #include <limits>
-#include <map>
+#include <memory>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 #include "common.h"
+#include "cursor.h"
+#include "flat_hash.h"
 #include "interval.h"
 #include "interval_union.h"
 
@@ -24,7 +24,7 @@ struct point {
 
 class sand_simulation {
 public:
-	explicit sand_simulation(std::istream& in);
+	explicit sand_simulation(std::string_view in);
 	point drop_sand();
 
 	constexpr bool has_floor(const std::intmax_t y) const noexcept {
@@ -33,28 +33,23 @@ public:
 
 private:
 	using hint_type =
-		std::map<std::intmax_t, interval_union>::const_iterator;
+		flat_hash_map<std::intmax_t, interval_union>::const_iterator;
 
 	[[nodiscard]] bool collide(const point p) const noexcept;
 	[[nodiscard]] bool
 	collide(const point p, hint_type hint) const noexcept;
 
 	std::intmax_t floor_y{};
-	std::map<std::intmax_t, interval_union> obstacles{};
+	// Rows are looked up once per step of a falling unit of sand
+	flat_hash_map<std::intmax_t, interval_union> obstacles{day_arena()};
 };
 
-bool expect_arrow(std::istream& in)
+bool read_point(cursor& c, point& p)
 {
-	static constexpr char arr[3]{' ', '-', '>'};
-	char buf[3];
-	if (!in.read(buf, 3)
-	    || !std::equal(std::execution::unseq, std::cbegin(buf),
-	                   std::cend(buf), std::cbegin(arr))) [[unlikely]]
-		in.setstate(std::ios_base::failbit);
-	return (bool) in;
+	return c.read_int(p.x) && c.expect(',') && c.read_int(p.y);
 }
 
-sand_simulation::sand_simulation(std::istream& in)
+sand_simulation::sand_simulation(const std::string_view in)
 {
 	using limits = std::numeric_limits<std::intmax_t>;
 	std::intmax_t max_x = 0;
@@ -65,27 +60,20 @@ sand_simulation::sand_simulation(std::istream& in)
 		if (p.y > max_y)
 			max_y = p.y;
 	};
-	for (;;) {
-		while (in.peek() == '\n')
-			in.ignore();
-		if (!in)
-			break;
+	cursor c{in};
+	for (c.skip_ws(); !c.empty(); c.skip_ws()) {
 		point p;
-		if (!(in >> p.x) || in.get() != ',' || !(in >> p.y)) {
-			in.setstate(std::ios_base::failbit);
-			break;
-		}
+		if (!read_point(c, p)) [[unlikely]]
+			throw std::runtime_error("Puzzle input error");
 		update_max(p);
-		if (in.peek() == '\n') {
+		if (c.empty() || c.peek() == '\n') {
 			obstacles[p.y].insert(interval{p.x, p.x});
 			continue;
 		}
-		while (in.peek() != '\n' && expect_arrow(in)) {
+		while (!c.empty() && c.peek() != '\n') {
 			point n;
-			if (!(in >> n.x) || in.get() != ',' || !(in >> n.y)) {
-				in.setstate(std::ios_base::failbit);
-				break;
-			}
+			if (!c.expect(" -> ") || !read_point(c, n)) [[unlikely]]
+				throw std::runtime_error("Puzzle input error");
 			update_max(n);
 			if (n.x == p.x) {
 				const auto [ya, yb] = std::minmax(n.y, p.y);
@@ -96,13 +84,9 @@ sand_simulation::sand_simulation(std::istream& in)
 			} else [[unlikely]] {
 				throw std::runtime_error("Unaligned line");
 			}
-			p = std::move(n);
+			p = n;
 		}
-		if (!in)
-			break;
 	}
-	if (!in.eof())
-		throw std::runtime_error("Puzzle input error");
 	floor_y = max_y + 2;
 	obstacles[floor_y].insert(interval{limits::min(), limits::max()});
 }
@@ -140,20 +124,48 @@ bool sand_simulation::collide(const point p) const noexcept
 	return collide(p, obstacles.find(p.y));
 }
 
-}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : sim{in} {}
+	puzzle_output part1() override;
+	puzzle_output part2() override;
+
+private:
+	[[nodiscard]] bool source_blocked() const noexcept {
+		return last.x == 500 && last.y == 0;
+	}
+
+	sand_simulation sim;
+	point last{0, 1};
+	std::uintmax_t dropped = 0;
+};
 
-template<> output_pair day<14>(std::istream& in)
+// Part 2 resumes the simulation where part 1 stopped
+puzzle_output solution::part1()
 {
-	sand_simulation sim{in};
-	std::uintmax_t count = 0;
-	std::uintmax_t fell = 0;
 	for (;;) {
-		const point s = sim.drop_sand();
-		if (sim.has_floor(s.y + 1) && fell == 0)
-			fell = count;
-		if (s.x == 500 && s.y == 0)
-			break;
-		++count;
+		last = sim.drop_sand();
+		++dropped;
+		// The unit on the floor fell out; the one at the source rested
+		if (sim.has_floor(last.y + 1))
+			return dropped - 1;
+		if (source_blocked())
+			return dropped;
 	}
-	return {fell, count + 1};
+}
+
+puzzle_output solution::part2()
+{
+	while (!source_blocked()) {
+		last = sim.drop_sand();
+		++dropped;
+	}
+	return dropped;
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<14>(std::string_view in)
+{
+	return std::make_unique<solution>(in);
 }
@@ -1,16 +1,20 @@
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <ios>
-#include <istream>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <span>
+#include <stdexcept>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "common.h"
+#include "exec_context.h"
 #include "interval.h"
 #include "interval_union.h"
+#include "scan.h"
 
 // TODO: try to optimize the interval_union away
 
@@ -53,11 +57,12 @@ private:
 };
 
 class sensor_report {
-	friend std::istream& operator>>(std::istream&, sensor_report&);
 public:
 	constexpr sensor_report() noexcept {}
+	void add(std::string_view line);
 	[[nodiscard]] std::uintmax_t beaconless_positions() const;
-	[[nodiscard]] constexpr std::uintmax_t beacon_tuning_frequency() const;
+	[[nodiscard]] std::uintmax_t
+	beacon_tuning_frequency(exec_context& ctx) const;
 
 private:
 	std::vector<sensor_reading> readings{};
@@ -68,43 +73,14 @@ private:
 	return x >= 0 ? x : -x;
 }
 
-static bool read_expect(std::istream& in, std::span<char, 25> buf,
-                        std::span<const char> exp)
+void sensor_report::add(std::string_view line)
 {
-	return in.read(buf.data(), exp.size())
-	       && std::equal(exp.begin(), exp.end(), buf.begin());
-}
-
-static bool read_point(std::istream& in, std::span<char, 25> buf, point& p)
-{
-	static constexpr char coord_sep[] = {',', ' ', 'y', '='};
-	return (in >> p.x) && read_expect(in, buf, coord_sep) && (in >> p.y);
-}
-
-std::istream& operator>>(std::istream& in, sensor_report& r)
-{
-	static constexpr char sensor_at[] = "Sensor at x=";
-	static constexpr char closest[] = ": closest beacon is at x=";
-	char buf[25];
-	while (in.peek() == '\n')
-		in.ignore();
-	if (!in.read(buf, 12))
-		return in;
-	if (!std::equal(sensor_at, sensor_at + 12, std::cbegin(buf))) {
-		in.setstate(std::ios_base::failbit);
-		return in;
-	}
 	point s;
-	if (!read_point(in, buf, s) || !read_expect(in, buf, {closest, 25})) {
-		in.setstate(std::ios_base::failbit);
-		return in;
-	}
 	point b;
-	if (read_point(in, buf, b) && in.get() == '\n')
-		r.readings.emplace_back(s, b);
-	else
-		in.setstate(std::ios_base::failbit);
-	return in;
+	if (!scan<"Sensor at x={}, y={}: closest beacon is at x={}, y={}">(
+		line, s.x, s.y, b.x, b.y) || !line.empty()) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	readings.emplace_back(s, b);
 }
 
 std::uintmax_t sensor_report::beaconless_positions()
@@ -120,22 +96,44 @@ std::uintmax_t sensor_report::beaconless_positions()
 	return u.cardinal();
 }
 
-constexpr std::uintmax_t sensor_report::beacon_tuning_frequency()
-	const
+/*
+ * Rows are searched in parallel. Once a row has the beacon, rows after it
+ * are skipped, and the lowest row found is kept so the answer is the one of
+ * the serial search. Each row checks for cancellation, which stops every
+ * chunk soon after the runner asks.
+ */
+std::uintmax_t
+sensor_report::beacon_tuning_frequency(exec_context& ctx) const
 {
 	const std::intmax_t limit = readings.size() == 14 ? 20 : 4000000;
-	for (std::intmax_t y = 0; y <= limit; ++y) {
+	std::atomic<std::intmax_t> found_row = limit + 1;
+	std::mutex found_mutex;
+	std::intmax_t found_x = 0;
+	const auto search = [&](const std::size_t row) {
+		ctx.check_cancelled();
+		const auto y = static_cast<std::intmax_t>(row);
+		if (y > found_row.load(std::memory_order_relaxed))
+			return;
 		interval_union u;
 		for (const sensor_reading& reading: readings) {
 			auto i = reading.vision_slice(y);
 			if (i)
 				u.insert(std::move(i).value());
 		}
-		auto o = u.dead_spot(interval<std::intmax_t>{0, limit});
-		if (o)
-			return 4000000 * o.value() + y;
-	}
-	throw std::runtime_error("No solution found");
+		const auto o = u.dead_spot(interval<std::intmax_t>{0, limit});
+		if (!o)
+			return;
+		const std::lock_guard lock{found_mutex};
+		if (y < found_row.load(std::memory_order_relaxed)) {
+			found_row.store(y, std::memory_order_relaxed);
+			found_x = o.value();
+		}
+	};
+	ctx.parallel_for(0, static_cast<std::size_t>(limit) + 1, search);
+	const std::intmax_t y = found_row.load();
+	if (y > limit)
+		throw std::runtime_error("No solution found");
+	return 4000000 * found_x + y;
 }
 
 constexpr std::optional<interval<std::intmax_t>>
@@ -167,13 +165,31 @@ sensor_reading::vision_slice(std::intmax_t row) const noexcept
 	return interval(position.x - dx, position.x + dx);
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in);
+	puzzle_output part1() override { return r.beaconless_positions(); }
+
+	puzzle_output part2() override {
+		return r.beacon_tuning_frequency(context());
+	}
+
+private:
+	sensor_report r{};
+};
+
+solution::solution(std::string_view in)
+{
+	while (!in.empty()) {
+		const std::string_view line = next_line(in);
+		if (!line.empty())
+			r.add(line);
+	}
 }
 
-template<> output_pair day<15>(std::istream& in)
+}
+
+template<> std::unique_ptr<parsed_input> parse<15>(std::string_view in)
 {
-	sensor_report r;
-	while (in >> r);
-	if (!in.eof())
-		throw std::runtime_error("Error while reading puzzle input");
-	return {r.beaconless_positions(), r.beacon_tuning_frequency()};
+	return std::make_unique<solution>(in);
 }
@@ -1,14 +1,17 @@
 #include <algorithm>
 #include <cstdint>
-#include <ios>
-#include <istream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "common.h"
-#include "read.h"
+#include "exec_context.h"
+#include "scan.h"
 
 namespace {
 
@@ -31,79 +34,51 @@ constexpr int letter_id(const char c)
 	return static_cast<int>(it - std::begin(runes));
 }
 
-std::istream& operator>>(std::istream& in, vertex_input_data &x)
+constexpr unsigned valve_id(const char a, const char b)
 {
-	using namespace std::literals;
-	using traits = std::istream::traits_type;
-	while (in.peek() == in.widen('\n'))
-		in.ignore();
-	if (!read_expect(in, "Valve "sv)) [[unlikely]]
-		return in;
-	int c = in.get();
-	if (c == traits::eof()) [[unlikely]]
-		return in;
-	x.name = static_cast<int>(letter_id(traits::to_char_type(c)));
-	if ((c = in.get()) == traits::eof()) [[unlikely]]
-		return in;
-	x.name = 26 * x.name
-	         + static_cast<int>(letter_id(traits::to_char_type(c)));
-	if (!read_expect(in, " has flow rate="sv) || !(in >> x.data.rate)
-	    || !read_expect(in, "; tunnel"sv)) [[unlikely]]
-		return in;
-	if (in.peek() == in.widen('s'))
-		in.ignore();
-	if (!read_expect(in, " lead"sv)) [[unlikely]]
-		return in;
-	if (in.peek() == in.widen('s'))
-		in.ignore();
-	if (!read_expect(in, " to valve"sv)) [[unlikely]]
-		return in;
-	if (in.peek() == in.widen('s'))
-		in.ignore();
-	x.data.neighbors.clear();
-	while (in.peek() == in.widen(' ')) {
-		in.ignore();
-		c = in.get();
-		if (c == traits::eof()) [[unlikely]]
-			return in;
-		unsigned n = static_cast<int>(
-			letter_id(traits::to_char_type(c))
-		);
-		c = in.get();
-		if (c == traits::eof()) [[unlikely]]
-			return in;
-		n = 26 * n
-		    + static_cast<int>(letter_id(traits::to_char_type(c)));
-		x.data.neighbors.push_back(n);
-		if (in.peek() == in.widen(','))
-			in.ignore();
-	}
-	c = in.peek();
-	if (c != traits::eof() && c != in.widen('\n'))
-		in.setstate(std::ios_base::failbit);
-	return in;
+	return static_cast<unsigned>(26 * letter_id(a) + letter_id(b));
+}
+
+// Tunnels, leads and valves lose their plural when there is one neighbor
+vertex_input_data parse_vertex(std::string_view line)
+{
+	vertex_input_data x;
+	char a;
+	char b;
+	std::string_view tunnel;
+	std::string_view lead;
+	std::string_view valve;
+	if (!scan<"Valve {}{} has flow rate={}; {} {} to {}">(
+		line, a, b, x.data.rate, tunnel, lead, valve)
+	    || !tunnel.starts_with("tunnel") || !lead.starts_with("lead")
+	    || !valve.starts_with("valve")) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	x.name = valve_id(a, b);
+	do {
+		if (!scan<" {}{}">(line, a, b)) [[unlikely]]
+			throw std::runtime_error("Error while reading puzzle input");
+		x.data.neighbors.push_back(valve_id(a, b));
+	} while (scan<",">(line));
+	if (!line.empty()) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	return x;
 }
 
-std::istream& operator>>(std::istream& in, std::vector<vertex_data>& v)
+std::vector<vertex_data> read_vertices(std::string_view in)
 {
 	std::vector<vertex_input_data> vidv;
 	std::vector<unsigned> names;
-	vertex_input_data vid;
-	while (in >> vid) {
-		names.push_back(vid.name);
-		vidv.emplace_back(std::move(vid));
-	}
-	if (names.empty()) [[unlikely]] {
-		in.setstate(std::ios_base::failbit);
-		return in;
+	while (!in.empty()) {
+		const std::string_view line = next_line(in);
+		if (line.empty())
+			continue;
+		vidv.push_back(parse_vertex(line));
+		names.push_back(vidv.back().name);
 	}
 	std::sort(names.begin(), names.end());
-	if (names.front() != 0) [[unlikely]] {
-		in.setstate(std::ios_base::failbit);
-		return in;
-	}
-	v.clear();
-	v.resize(vidv.size());
+	if (names.empty() || names.front() != 0) [[unlikely]]
+		throw std::runtime_error("Error while reading puzzle input");
+	std::vector<vertex_data> v(vidv.size());
 	const auto id = [&names](unsigned n) noexcept {
 		return std::lower_bound(names.cbegin(), names.cend(), n)
 		       - names.cbegin();
@@ -114,18 +89,20 @@ std::istream& operator>>(std::istream& in, std::vector<vertex_data>& v)
 		for (unsigned nj : x.data.neighbors)
 			y.neighbors.emplace_back(id(nj));
 	}
-	return in;
+	return v;
 }
 
 class solver_state {
 public:
 	explicit solver_state(const std::vector<vertex_data>& v);
 
-	[[nodiscard]] std::uintmax_t solve(unsigned t, unsigned a) {
+	[[nodiscard]] std::uintmax_t
+	solve(unsigned t, unsigned a, std::stop_token s) {
 		if (t > 30) [[unlikely]]
 			throw std::invalid_argument("Time limit too high");
 		if (a == 0 || a > 2) [[unlikely]]
 			throw std::invalid_argument("Wrong number of agents");
+		stop = std::move(s);
 		return solve(0, 0, t, a);
 	}
 
@@ -136,6 +113,9 @@ private:
 	std::vector<std::uintmax_t> rates{};
 	std::vector<unsigned> distances{};
 	std::vector<std::uintmax_t> memoizer{};
+	std::stop_token stop{};
+	// Memoizer misses since cancellation was last checked
+	unsigned misses = 0;
 };
 
 solver_state::solver_state(const std::vector<vertex_data>& v)
@@ -191,6 +171,9 @@ solver_state::solve(unsigned valve, std::uintmax_t opened, unsigned t,
 		((opened * rates.size() + valve) * 31 + t) * 2 + a);
 	if (memo != 0)
 		return memo;
+	if (++misses % 4096 == 0)
+		if (stop.stop_requested()) [[unlikely]]
+			throw cancelled_error("Cancelled");
 	if (t == 0)
 		return a == 2 ? solve(0, opened, 26, 1) : 0;
 	std::uintmax_t acc = 0;
@@ -213,14 +196,26 @@ solver_state::solve(unsigned valve, std::uintmax_t opened, unsigned t,
 	return acc;
 }
 
+// Both parts share the memoizer, so they must not run concurrently
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in)
+		: solver{read_vertices(in)} {}
+	puzzle_output part1() override {
+		return solver.solve(30, 1, context().stop_token());
+	}
+
+	puzzle_output part2() override {
+		return solver.solve(26, 2, context().stop_token());
+	}
+
+private:
+	solver_state solver;
+};
+
 }
 
-template<> output_pair day<16>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<16>(std::string_view in)
 {
-	std::vector<vertex_data> v;
-	in >> v;
-	if (!in.eof())
-		throw std::runtime_error("Error while reading puzzle input");
-	solver_state solver{std::move(v)};
-	return {solver.solve(30, 1), solver.solve(26, 2)};
+	return std::make_unique<solution>(in);
 }
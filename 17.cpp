@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <deque>
 #include <istream>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -215,13 +216,28 @@ void boulder_cave::drop_boulder()
 	advance_cyclical(piece_type, pieces);
 }
 
+// Part 2 keeps dropping boulders on the pile left by part 1
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : cave{in} {}
+
+	puzzle_output part1() override {
+		cave.drop_boulders(2022);
+		return cave.height();
+	}
+
+	puzzle_output part2() override {
+		cave.drop_boulders(1000000000000 - 2022);
+		return cave.height();
+	}
+
+private:
+	boulder_cave cave;
+};
+
 }
 
-template<> output_pair day<17>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<17>(std::istream& in)
 {
-	boulder_cave cave{in};
-	cave.drop_boulders(2022);
-	const std::uintmax_t part1 = cave.height();
-	cave.drop_boulders(1000000000000 - 2022);
-	return {part1, cave.height()};
+	return std::make_unique<solution>(in);
 }
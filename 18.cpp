@@ -1,26 +1,35 @@
 #include <cstddef>
 #include <cstdint>
 #include <deque>
-#include <functional>
-#include <ios>
-#include <istream>
 #include <limits>
 #include <memory>
+#include <stdexcept>
+#include <string_view>
 
+#include "bit_grid.h"
 #include "common.h"
+#include "cursor.h"
 
 namespace {
 
-enum class cube { empty, lava, water };
-
+/*
+ * The droplet is kept with one empty cube of padding on every side, so that
+ * water can reach all of its outside from a corner and every face of lava is
+ * inside the box.
+ */
 class droplet {
 public:
-	explicit droplet(std::istream& in) {
+	explicit droplet(const std::string_view in) {
 		using limit = std::numeric_limits<std::size_t>;
-		using traits = std::istream::traits_type;
 		std::deque<point> points;
+		cursor c{in};
 		point p;
-		while (read_point(in, p)) {
+		std::size_t width = 0;
+		std::size_t height = 0;
+		std::size_t depth = 0;
+		for (c.skip_ws(); !c.empty(); c.skip_ws()) {
+			if (!read_point(c, p) || !(c.expect('\n') || c.empty()))
+				throw std::runtime_error("Puzzle input parsing error");
 			if (p.x > width)
 				width = p.x;
 			if (p.y > height)
@@ -28,53 +37,25 @@ public:
 			if (p.z > depth)
 				depth = p.z;
 			points.push_back(p);
-			const traits::int_type c = in.get();
-			if (c != traits::to_int_type('\n')) {
-				in.setstate(std::ios_base::failbit);
-				break;
-			}
 		}
-		if (!in.eof())
-			throw std::runtime_error("Puzzle input parsing error");
 		constexpr std::size_t max_coord =
-			(std::size_t{1} << (limit::digits / 3)) - 2;
+			(std::size_t{1} << (limit::digits / 3)) - 3;
 		if (width > max_coord || height > max_coord
 		    || depth > max_coord)
 			throw std::runtime_error("Droplet is too big");
-		++width;
-		++height;
-		++depth;
-		mask = std::make_unique<cube[]>(width * height * depth);
-		std::fill(begin(), end(), cube::empty);
+		lava = bit_volume{width + 3, height + 3, depth + 3};
 		for (point m : points)
-			coord(m.x, m.y, m.z) = cube::lava;
+			lava.set(m.x + 1, m.y + 1, m.z + 1);
 		submerge();
 	}
 
-	[[nodiscard]] constexpr std::uintmax_t surface() const noexcept {
-		constexpr auto p = [](cube c) { return c != cube::lava; };
-		std::uintmax_t count = 0;
-		for (std::size_t x = 0; x < width; ++x) {
-			for (std::size_t y = 0; y < height; ++y) {
-				for (std::size_t z = 0; z < depth; ++z) {
-					count += surface_cube(x, y, z, p);
-				}
-			}
-		}
-		return count;
+	// Faces of lava cubes, minus those where two of them touch
+	[[nodiscard]] std::uintmax_t surface() const noexcept {
+		return 6 * lava.count() - lava.count_touching(lava);
 	}
 
-	[[nodiscard]] constexpr std::uintmax_t surface_water() const noexcept {
-		constexpr auto p = [](cube c) { return c == cube::water; };
-		std::uintmax_t count = 0;
-		for (std::size_t x = 0; x < width; ++x) {
-			for (std::size_t y = 0; y < height; ++y) {
-				for (std::size_t z = 0; z < depth; ++z) {
-					count += surface_cube(x, y, z, p);
-				}
-			}
-		}
-		return count;
+	[[nodiscard]] std::uintmax_t surface_water() const noexcept {
+		return surface() - pockets.count_touching(lava);
 	}
 
 private:
@@ -84,109 +65,42 @@ private:
 		std::size_t z;
 	};
 
-	[[nodiscard]] cube* begin() noexcept { return mask.get(); }
-
-	[[nodiscard]] cube* end() noexcept {
-		return mask.get() + width * height * depth;
-	}
-
-	static std::istream& read_point(std::istream& in, point& p) {
-		const auto comma = [&in] {
-			using traits = std::istream::traits_type;
-			return in.get() == traits::to_int_type(',');
-		};
-		if (!(in >> p.x) || !comma() || !(in >> p.y) || !comma())
-			in.setstate(std::ios_base::failbit);
-		return in >> p.z;
-	}
-
-	[[nodiscard]] cube&
-	coord(std::size_t x, std::size_t y, std::size_t z) noexcept
-	{
-		return mask.get()[(z * height + y) * width + x];
-	}
-
-	[[nodiscard]] const cube&
-	coord(std::size_t x, std::size_t y, std::size_t z) const noexcept
-	{
-		return mask.get()[(z * height + y) * width + x];
+	static bool read_point(cursor& c, point& p) {
+		return c.read_uint(p.x) && c.expect(',') && c.read_uint(p.y)
+		       && c.expect(',') && c.read_uint(p.z);
 	}
 
+	// Air pockets are what is neither lava nor reached by water
 	void submerge() {
-		submerge_z_plan(0);
-		for (std::size_t z = 1; z + 1 < depth; ++z) {
-			submerge_y_line(0, z);
-			for (std::size_t y = 1; y + 1 < height; ++y) {
-				submerge_cube(0, y, z);
-				submerge_cube(width - 1, y, z);
-			}
-			submerge_y_line(height - 1, z);
-		}
-		submerge_z_plan(depth - 1);
-	}
-
-	void submerge_z_plan(const std::size_t z) {
-		for (std::size_t y = 0; y < height; ++y)
-			submerge_y_line(y, z);
-	}
-
-	void submerge_y_line(const std::size_t y, const std::size_t z) {
-		for (std::size_t x = 0; x < width; ++x)
-			submerge_cube(x, y, z);
+		bit_volume corner{lava};
+		corner.clear();
+		corner.set(0, 0, 0);
+		bit_volume passable{lava};
+		passable.flip();
+		bit_search<bit_volume> water{corner};
+		while (water.step(passable));
+		pockets = water.visited();
+		pockets.flip();
+		pockets.and_not(lava);
 	}
 
-	void submerge_cube(std::size_t x, std::size_t y, std::size_t z) {
-		cube& p = coord(x, y, z);
-		if (p != cube::empty)
-			return;
-		p = cube::water;
-		if (x > 0)
-			submerge_cube(x - 1, y, z);
-		if (x + 1 < width)
-			submerge_cube(x + 1, y, z);
-		if (y > 0)
-			submerge_cube(x, y - 1, z);
-		if (y + 1 < height)
-			submerge_cube(x, y + 1, z);
-		if (z > 0)
-			submerge_cube(x, y, z - 1);
-		if (z + 1 < depth)
-			submerge_cube(x, y, z + 1);
-	}
+	bit_volume lava{};
+	bit_volume pockets{};
+};
 
-	template<class P>
-	constexpr std::uintmax_t
-	surface_cube(std::size_t x, std::size_t y, std::size_t z, const P& p)
-		const noexcept
-	{
-		if (coord(x, y, z) != cube::lava)
-			return 0;
-		std::uintmax_t count = 0;
-		if (x == 0 || std::invoke(p, coord(x - 1, y, z)))
-			++count;
-		if (x + 1 == width || std::invoke(p, coord(x + 1, y, z)))
-			++count;
-		if (y == 0 || std::invoke(p, coord(x, y - 1, z)))
-			++count;
-		if (y + 1 == height || std::invoke(p, coord(x, y + 1, z)))
-			++count;
-		if (z == 0 || std::invoke(p, coord(x, y, z - 1)))
-			++count;
-		if (z + 1 == depth || std::invoke(p, coord(x, y, z + 1)))
-			++count;
-		return count;
-	}
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : d{in} {}
+	puzzle_output part1() override { return d.surface(); }
+	puzzle_output part2() override { return d.surface_water(); }
 
-	std::size_t width = 0;
-	std::size_t height = 0;
-	std::size_t depth = 0;
-	std::unique_ptr<cube[]> mask = nullptr;
+private:
+	droplet d;
 };
 
 }
 
-template<> output_pair day<18>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<18>(std::string_view in)
 {
-	const droplet d{in};
-	return {d.surface(), d.surface_water()};
+	return std::make_unique<solution>(in);
 }
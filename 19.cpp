@@ -1,15 +1,16 @@
+#include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <ios>
-#include <istream>
 #include <iterator>
 #include <memory>
+#include <stop_token>
 #include <numeric>
 #include <string_view>
 #include <vector>
 
 #include "common.h"
-#include "read.h"
+#include "exec_context.h"
+#include "scan.h"
 
 namespace {
 
@@ -23,53 +24,26 @@ struct blueprint {
 	unsigned int max_ore;
 };
 
-[[nodiscard]]
-constexpr unsigned int max_geodes(const blueprint& bp, int t) noexcept;
-
-static bool consume_whitespace_characters(std::istream& in);
+[[nodiscard]] unsigned int
+max_geodes(const blueprint& bp, int t, const std::stop_token& stop);
 
 class factory {
 public:
-	explicit factory(std::istream& in) {
-		using namespace std::literals;
-		using traits = std::istream::traits_type;
-		constexpr std::string_view bp1 = "Blueprint"sv;
-		constexpr std::string_view bp2 = "Each ore robot costs"sv;
-		constexpr std::string_view bp3 = " ore."sv;
-		constexpr std::string_view bp4 = "Each clay robot costs"sv;
-		constexpr std::string_view bp5 = "Each obsidian robot costs"sv;
-		constexpr std::string_view bp6 = " ore and"sv;
-		constexpr std::string_view bp7 = " clay."sv;
-		constexpr std::string_view bp8 = "Each geode robot costs"sv;
-		constexpr std::string_view bp9 = " obsidian."sv;
-		while (consume_whitespace_characters(in)) {
+	// Blueprints may be wrapped over several lines
+	explicit factory(std::string_view in) {
+		while (in.find_first_not_of(" \n") != in.npos) {
 			decltype(bp)::size_type id;
-			if (!read_expect(in, bp1) || !(in >> id))
+			blueprint b;
+			if (!scan<" Blueprint {}: Each ore robot costs {} ore. "
+			          "Each clay robot costs {} ore. "
+			          "Each obsidian robot costs {} ore and {} clay. "
+			          "Each geode robot costs {} ore and {} obsidian. ">(
+				in, id, b.ore_cost, b.clay_cost,
+				b.obsidian_cost_ore, b.obsidian_cost_clay,
+				b.geode_cost_ore, b.geode_cost_obsidian))
 				throw std::runtime_error("Puzzle input error");
 			if (id != std::size(bp) + 1)
 				throw std::runtime_error("Wrong blueprint ID");
-			if (in.get() != traits::to_int_type(':')
-			    || !consume_whitespace_characters(in)
-			    || !read_expect(in, bp2))
-				throw std::runtime_error("Puzzle input error");
-			blueprint b;
-			if (!(in >> b.ore_cost) || !read_expect(in, bp3)
-			    || !consume_whitespace_characters(in)
-			    || !read_expect(in, bp4) || !(in >> b.clay_cost)
-			    || !read_expect(in, bp3)
-			    || !consume_whitespace_characters(in)
-			    || !read_expect(in, bp5)
-			    || !(in >> b.obsidian_cost_ore)
-			    || !read_expect(in, bp6)
-			    || !(in >> b.obsidian_cost_clay)
-			    || !read_expect(in, bp7)
-			    || !consume_whitespace_characters(in)
-			    || !read_expect(in, bp8)
-			    || !(in >> b.geode_cost_ore)
-			    || !read_expect(in, bp6)
-			    || !(in >> b.geode_cost_obsidian)
-			    || !read_expect(in, bp9))
-				throw std::runtime_error("Puzzle input error");
 			b.max_ore = b.ore_cost;
 			if (b.clay_cost > b.max_ore)
 				b.max_ore = b.clay_cost;
@@ -79,27 +53,30 @@ public:
 				b.max_ore = b.geode_cost_ore;
 			bp.push_back(b);
 		}
-		if (!in.eof())
-			throw std::runtime_error("Puzzle input error");
 	}
 
+	// Blueprints are independent, so each one can go to its own thread
 	[[nodiscard]]
-	constexpr std::uintmax_t sum_quality_levels() const noexcept {
-		std::uintmax_t acc = 0;
-		std::uintmax_t d = 0;
-		for (const auto& b : bp)
-			acc += ++d * max_geodes(b, 24);
-		return acc;
+	std::uintmax_t sum_quality_levels(exec_context& ctx) const {
+		return ctx.parallel_reduce(
+			std::size_t{0}, std::size(bp), std::uintmax_t{0},
+			[this, &ctx](std::size_t i) -> std::uintmax_t {
+				return (i + 1) * max_geodes(bp[i], 24,
+				                            ctx.stop_token());
+			},
+			std::plus{}
+		);
 	}
 
 	[[nodiscard]]
-	constexpr std::uintmax_t product_geodes() const noexcept {
-		const auto beg = std::cbegin(bp);
-		const auto end = std::size(bp) >= 3 ? std::next(beg, 3)
-		                                    : std::cend(bp);
-		return std::transform_reduce(
-			beg, end, std::uintmax_t{1}, std::multiplies{},
-			[](const blueprint& b) { return max_geodes(b, 32); }
+	std::uintmax_t product_geodes(exec_context& ctx) const {
+		const std::size_t n = std::size(bp) >= 3 ? 3 : std::size(bp);
+		return ctx.parallel_reduce(
+			std::size_t{0}, n, std::uintmax_t{1},
+			[this, &ctx](std::size_t i) -> std::uintmax_t {
+				return max_geodes(bp[i], 32, ctx.stop_token());
+			},
+			std::multiplies{}
 		);
 	}
 
@@ -121,21 +98,16 @@ struct state {
 	unsigned int geode_bot;
 };
 
-static bool consume_whitespace_characters(std::istream& in)
-{
-	using traits = std::istream::traits_type;
-	std::istream::int_type c;
-	while ((c = in.peek()) == traits::to_int_type(' ')
-	       || c == traits::to_int_type('\n'))
-		in.ignore();
-	return in.good();
-}
+// Nodes this far from the end are rare enough to check for cancellation
+constexpr int cancel_check_depth = 8;
 
-constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
-	noexcept
+unsigned int backtrack(const blueprint& bp, const state& s, int t,
+                       const std::stop_token& stop)
 {
 	if (t == 0)
 		return s.geode;
+	if (t >= cancel_check_depth && stop.stop_requested()) [[unlikely]]
+		throw cancelled_error("Cancelled");
 	if (s.ore >= bp.geode_cost_ore
 	    && s.obsidian >= bp.geode_cost_obsidian) {
 		state n = s;
@@ -147,7 +119,7 @@ constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
 		n.geode += n.geode_bot;
 		++n.geode_bot;
 		n.skipped_ore = n.skipped_clay = n.skipped_obsidian = false;
-		return backtrack(bp, n, t - 1);
+		return backtrack(bp, n, t - 1, stop);
 	}
 	unsigned int acc = 0;
 	const bool can_ore = s.ore >= bp.ore_cost;
@@ -160,7 +132,7 @@ constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
 		n.geode += n.geode_bot;
 		++n.ore_bot;
 		n.skipped_ore = n.skipped_clay = n.skipped_obsidian = false;
-		const unsigned int r = backtrack(bp, n, t - 1);
+		const unsigned int r = backtrack(bp, n, t - 1, stop);
 		if (r > acc)
 			acc = r;
 	}
@@ -175,7 +147,7 @@ constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
 		n.geode += n.geode_bot;
 		++n.clay_bot;
 		n.skipped_ore = n.skipped_clay = n.skipped_obsidian = false;
-		const unsigned int r = backtrack(bp, n, t - 1);
+		const unsigned int r = backtrack(bp, n, t - 1, stop);
 		if (r > acc)
 			acc = r;
 	}
@@ -192,7 +164,7 @@ constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
 		n.geode += n.geode_bot;
 		++n.obsidian_bot;
 		n.skipped_ore = n.skipped_clay = n.skipped_obsidian = false;
-		const unsigned int r = backtrack(bp, n, t - 1);
+		const unsigned int r = backtrack(bp, n, t - 1, stop);
 		if (r > acc)
 			acc = r;
 	}
@@ -204,22 +176,37 @@ constexpr unsigned int backtrack(const blueprint& bp, const state& s, int t)
 	n.skipped_ore |= can_ore;
 	n.skipped_clay |= can_clay;
 	n.skipped_obsidian |= can_obsidian;
-	const unsigned int r = backtrack(bp, n, t - 1);
+	const unsigned int r = backtrack(bp, n, t - 1, stop);
 	if (r > acc)
 		acc = r;
 	return acc;
 }
 
-constexpr unsigned int max_geodes(const blueprint& bp, int t) noexcept
+unsigned int
+max_geodes(const blueprint& bp, int t, const std::stop_token& stop)
 {
 	const state initial{0, 1, false, 0, 0, false, 0, 0, false, 0, 0};
-	return backtrack(bp, initial, t);
+	return backtrack(bp, initial, t, stop);
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : f{in} {}
+	puzzle_output part1() override {
+		return f.sum_quality_levels(context());
+	}
+
+	puzzle_output part2() override {
+		return f.product_geodes(context());
+	}
+
+private:
+	factory f;
+};
+
 }
 
-template<> output_pair day<19>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<19>(std::string_view in)
 {
-	const factory f{in};
-	return {f.sum_quality_levels(), f.product_geodes()};
+	return std::make_unique<solution>(in);
 }
@@ -1,17 +1,19 @@
 #include <algorithm>
 #include <cstdint>
 #include <deque>
-#include <istream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "checked.h"
 #include "common.h"
+#include "cursor.h"
 
 namespace {
 
@@ -33,20 +35,21 @@ constexpr container_type::value_type min_val =
 constexpr container_type::value_type max_val =
 	std::numeric_limits<container_type::value_type>::max() / 811589153;
 
-static container_type parse(std::istream& in)
+static container_type read_numbers(const std::string_view in)
 {
 	container_type c;
 	container_type::value_type n;
 	container_type::size_type zeros = 0;
-	while (in >> n) {
+	cursor r{in};
+	for (r.skip_ws(); !r.empty(); r.skip_ws()) {
+		if (!r.read_int(n)) [[unlikely]]
+			throw std::runtime_error("Error while reading puzzle input");
 		if (n == 0)
 			++zeros;
 		if (n < min_val || n > max_val)
 			throw std::runtime_error("Value out of range");
 		c.emplace_back(std::move(n));
 	}
-	if (!in.eof())
-		throw std::runtime_error("Error while reading puzzle input");
 	if (zeros != 1)
 		throw std::runtime_error("Wrong number of zeros in input");
 	if (std::size(c) == std::numeric_limits<decltype(c)::size_type>::max())
@@ -195,17 +198,40 @@ static std::intmax_t find_grove_coordinates(const container_type& c)
 	return find_grove_coordinates(mix(c, 1));
 }
 
-template<> output_pair day<20>(std::istream& in)
+namespace {
+
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : c{read_numbers(in)} {}
+	puzzle_output part1() override;
+	puzzle_output part2() override;
+
+private:
+	container_type c;
+};
+
+puzzle_output solution::part1()
 {
-	container_type c = parse(in);
-	const std::intmax_t part1 = first_try(c);
-	if (part1 < 0)
+	const std::intmax_t r = first_try(c);
+	if (r < 0)
 		throw std::runtime_error("Grove coordinate is negative");
-	for (auto& x : c)
+	return static_cast<std::uintmax_t>(r);
+}
+
+puzzle_output solution::part2()
+{
+	container_type decrypted = c;
+	for (auto& x : decrypted)
 		x *= key;
-	const std::intmax_t part2 = find_grove_coordinates(mix(c, 10));
-	if (part2 < 0)
+	const std::intmax_t r = find_grove_coordinates(mix(decrypted, 10));
+	if (r < 0)
 		throw std::runtime_error("Grove coordinate is negative");
-	return {static_cast<std::uintmax_t>(part1),
-	        static_cast<std::uintmax_t>(part2)};
+	return static_cast<std::uintmax_t>(r);
+}
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<20>(std::string_view in)
+{
+	return std::make_unique<solution>(in);
 }
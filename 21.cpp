@@ -3,13 +3,14 @@
 #include <ios>
 #include <istream>
 #include <limits>
-#include <map>
+#include <memory>
 #include <span>
 #include <stdexcept>
 #include <utility>
 #include <variant>
 
 #include "common.h"
+#include "flat_hash.h"
 
 namespace {
 
@@ -27,6 +28,10 @@ struct expression {
 	monkey_type right;
 };
 
+// Entries are only inserted or overwritten, so none moves while solving
+using job_map =
+	flat_hash_map<monkey_type, std::variant<std::intmax_t, expression>>;
+
 [[nodiscard]] constexpr monkey_type parse_monkey(std::span<const char, 4> name)
 {
 	using std::invalid_argument;
@@ -59,8 +64,7 @@ static std::istream& consume_whitespace(std::istream& in)
 }
 
 static std::istream&
-parse_job(std::map<monkey_type, std::variant<std::intmax_t, expression>>& dst,
-          std::istream& in)
+parse_job(job_map& dst, std::istream& in)
 {
 	using traits = std::istream::traits_type;
 	if (!consume_whitespace(in))
@@ -117,10 +121,10 @@ parse_job(std::map<monkey_type, std::variant<std::intmax_t, expression>>& dst,
 }
 
 [[nodiscard]]
-static std::map<monkey_type, std::variant<std::intmax_t, expression>>
-parse(std::istream& in)
+static job_map
+read_jobs(std::istream& in)
 {
-	std::map<monkey_type, std::variant<std::intmax_t, expression>> result;
+	job_map result{day_arena()};
 	while (parse_job(result, in));
 	if (!in.eof())
 		throw std::runtime_error("Error while parsing puzzle input");
@@ -167,8 +171,7 @@ calculate(operation op, std::intmax_t left, std::intmax_t right)
 }
 
 [[nodiscard]] static std::intmax_t
-calc_reduce(std::map<monkey_type, std::variant<std::intmax_t, expression>>& j,
-            const monkey_type x)
+calc_reduce(job_map& j, const monkey_type x)
 {
 	const auto it = j.find(x);
 	if (it == j.end())
@@ -185,7 +188,7 @@ calc_reduce(std::map<monkey_type, std::variant<std::intmax_t, expression>>& j,
 }
 
 [[nodiscard]] static std::uintmax_t
-predict_root(std::map<monkey_type, std::variant<std::intmax_t, expression>> j)
+predict_root(job_map j)
 {
 	const std::intmax_t result = calc_reduce(j, root_monkey());
 	if (result < 0)
@@ -194,10 +197,7 @@ predict_root(std::map<monkey_type, std::variant<std::intmax_t, expression>> j)
 }
 
 [[nodiscard]] static int
-locate_humn(const std::map<monkey_type,
-                           std::variant<std::intmax_t, expression>>& m,
-            std::map<monkey_type,
-                     std::variant<std::intmax_t, expression>>::const_iterator it)
+locate_humn(const job_map& m, job_map::const_iterator it)
 {
 	if (it->first == humn_id())
 		return 0b11;
@@ -217,7 +217,7 @@ locate_humn(const std::map<monkey_type,
 }
 
 [[nodiscard]] static std::intmax_t
-update_target_left(std::map<monkey_type, std::variant<std::intmax_t, expression>>& j,
+update_target_left(job_map& j,
                    operation op, monkey_type right, std::intmax_t target)
 {
 	switch (op) {
@@ -235,7 +235,7 @@ update_target_left(std::map<monkey_type, std::variant<std::intmax_t, expression>
 }
 
 [[nodiscard]] static std::intmax_t
-update_target_right(std::map<monkey_type, std::variant<std::intmax_t, expression>>& j,
+update_target_right(job_map& j,
                     monkey_type left, operation op, std::intmax_t target)
 {
 	switch (op) {
@@ -253,7 +253,7 @@ update_target_right(std::map<monkey_type, std::variant<std::intmax_t, expression
 }
 
 [[nodiscard]] static std::uintmax_t
-solve_input(std::map<monkey_type, std::variant<std::intmax_t, expression>>&& j,
+solve_input(job_map&& j,
             monkey_type to_solve, std::intmax_t target)
 {
 	if (to_solve == humn_id())
@@ -279,7 +279,7 @@ solve_input(std::map<monkey_type, std::variant<std::intmax_t, expression>>&& j,
 }
 
 [[nodiscard]] static std::uintmax_t
-solve_input(std::map<monkey_type, std::variant<std::intmax_t, expression>>&& j)
+solve_input(job_map&& j)
 {
 	const auto it = j.find(root_monkey());
 	if (it == j.cend())
@@ -304,11 +304,25 @@ solve_input(std::map<monkey_type, std::variant<std::intmax_t, expression>>&& j)
 	}
 }
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : jobs{read_jobs(in)} {}
+	// Copies use the default resource unless told otherwise
+	puzzle_output part1() override {
+		return predict_root(job_map{jobs, day_arena()});
+	}
+
+	puzzle_output part2() override {
+		return solve_input(job_map{jobs, day_arena()});
+	}
+
+private:
+	job_map jobs;
+};
+
 }
 
-template<> output_pair day<21>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<21>(std::istream& in)
 {
-	auto jobs = parse(in);
-	const std::uintmax_t root_prediction = predict_root(jobs);
-	return {root_prediction, solve_input(std::move(jobs))};
+	return std::make_unique<solution>(in);
 }
@@ -538,10 +538,19 @@ private:
 	transition transitions[24]{};
 };
 
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : g{in} {}
+	puzzle_output part1() override { return g.solve_flat(); }
+	puzzle_output part2() override { return g.solve_cube(); }
+
+private:
+	grid g;
+};
+
 }
 
-template<> output_pair day<22>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<22>(std::istream& in)
 {
-	const grid g{in};
-	return {g.solve_flat(), g.solve_cube()};
+	return std::make_unique<solution>(in);
 }
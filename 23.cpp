@@ -11,6 +11,7 @@
 
 #include "checked.h"
 #include "common.h"
+#include "exec_context.h"
 
 namespace {
 
@@ -282,15 +283,32 @@ void elf_herd::move_elves(
 		stabilized = true;
 }
 
+// Part 2 resumes the rounds where part 1 stopped
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : herd{in} {}
+
+	puzzle_output part1() override {
+		for (int i = 0; i < 10 && !herd; ++i)
+			herd.resume();
+		return herd.empty_space();
+	}
+
+	puzzle_output part2() override {
+		while (!herd) {
+			context().check_cancelled();
+			herd.resume();
+		}
+		return herd.get_round();
+	}
+
+private:
+	elf_herd herd;
+};
+
 }
 
-template<> output_pair day<23>(std::istream& in)
+template<> std::unique_ptr<parsed_input> parse<23>(std::istream& in)
 {
-	elf_herd herd{in};
-	for (int i = 0; i < 10 && !herd; ++i)
-		herd.resume();
-	const std::uintmax_t part1 = herd.empty_space();
-	while (!herd)
-		herd.resume();
-	return {part1, herd.get_round()};
+	return std::make_unique<solution>(in);
 }
@@ -1,166 +1,122 @@
-#include <algorithm>
 #include <cstddef>
-#include <execution>
+#include <cstdint>
 #include <istream>
-#include <set>
+#include <memory>
 #include <stdexcept>
-#include <tuple>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "bit_grid.h"
 #include "common.h"
 
-class valley {
-public:
-	explicit valley(std::istream& in) {
-		std::string line;
-		while (std::getline(in, line)) {
-			if (!line.empty())
-				lines.emplace_back(std::move(line));
-		}
-		if (lines.empty())
-			throw std::runtime_error("Empty");
-		for (auto it = lines.cbegin() + 1; it != lines.cend(); ++it) {
-			if (it->size() != lines.front().size())
-				throw std::runtime_error("Inconsistent width");
-		}
-	}
-	
-private:
-	std::vector<std::string> lines{};
-};
+namespace {
 
+/*
+ * The blizzards going each way are kept as sets of cells of the inside of the
+ * valley, which all rotate by one cell a minute; the cells free of them are
+ * the complement of their union. Positions inside the valley reachable at a
+ * given minute are a set too, moved a minute forward by spreading it and
+ * keeping the free cells.
+ */
 class state {
 public:
-	state(const std::vector<std::string>& lines)
-		: blizzards(lines.size())
-		, xo{1}
-		, yo{0}
+	explicit state(const std::vector<std::string>& lines)
+		: up{inside(lines.front().size()), inside(lines.size())}
+		, down{up}
+		, left{up}
+		, right{up}
+		, free{up}
+		, frontier{up}
+		, next{up}
 	{
-		blizzards.front().resize(lines.front().size(), 0);
 		for (std::size_t i = 1; i + 1 < lines.size(); ++i) {
-			blizzards[i].resize(lines.front().size(), 0);
-			for (std::size_t j = 1; j + 1 < lines.front().size(); ++j) {
+			for (std::size_t j = 1; j + 1 < lines[i].size(); ++j) {
 				switch (lines[i][j]) {
 				case '^':
-					blizzards[i][j] = 1;
+					up.set(j - 1, i - 1);
 					break;
 				case 'v':
-					blizzards[i][j] = 2;
+					down.set(j - 1, i - 1);
 					break;
 				case '<':
-					blizzards[i][j] = 4;
+					left.set(j - 1, i - 1);
 					break;
 				case '>':
-					blizzards[i][j] = 8;
+					right.set(j - 1, i - 1);
 					break;
 				}
 			}
 		}
-		blizzards.back().resize(lines.front().size(), 0);
 	}
 
 	[[nodiscard]] std::uintmax_t distance_exit() {
-		std::set<std::pair<std::size_t, std::size_t>> frontier{
-			std::pair{xo, yo}
-		};
-		std::uintmax_t step = 1;
-		while (!frontier.empty()) {
-			advance_blizzards();
-			std::set<std::pair<std::size_t, std::size_t>> n;
-			for (auto [x, y] : frontier) {
-				if (x + 2 == blizzards.front().size() && y + 2 == blizzards.size())
-					return step;
-				if (blizzards[y][x] == 0)
-					n.emplace(x, y);
-				if (x > 1 && blizzards[y][x - 1] == 0)
-					n.emplace(x - 1, y);
-				if (y > 0 && x + 2 < blizzards.front().size() && blizzards[y][x + 1] == 0)
-					n.emplace(x + 1, y);
-				if ((y == 1 && x == 1) || (y > 1 && blizzards[y - 1][x] == 0))
-					n.emplace(x, y - 1);
-				if (y + 2 < blizzards.size() && blizzards[y + 1][x] == 0)
-					n.emplace(x, y + 1);
-			}
-			frontier = std::move(n);
-			++step;
-		}
-		throw std::runtime_error("No solution found");
+		return cross(first(), before_exit());
 	}
 
 	[[nodiscard]] std::uintmax_t distance_three() {
-		std::set<std::tuple<std::size_t, std::size_t, int>> frontier{
-			std::tuple(xo, yo, 0)
-		};
-		std::uintmax_t step = 1;
-		while (!frontier.empty()) {
-			advance_blizzards();
-			std::set<std::tuple<std::size_t, std::size_t, int>> n;
-			for (auto [x, y, s] : frontier) {
-				if (s == 2 && x + 2 == blizzards.front().size()
-				    && y + 2 == blizzards.size())
-					return step;
-				if (blizzards[y][x] == 0)
-					n.emplace(x, y, s);
-				if (y + 1 != blizzards.size() && x > 1 && blizzards[y][x - 1] == 0)
-					n.emplace(x - 1, y, s);
-				if (y > 0 && x + 2 < blizzards.front().size() && blizzards[y][x + 1] == 0)
-					n.emplace(x + 1, y, s);
-				if (x == 1 && y == 1) {
-					if (s == 1) {
-						n.clear();
-						n.emplace(x, y - 1, 2);
-						break;
-					}
-					n.emplace(x, y - 1, s);
-				} else if (y > 1 && blizzards[y - 1][x] == 0) {
-					n.emplace(x, y - 1, s);
-				}
-				if (x + 2 == blizzards.front().size() && y + 2 == blizzards.size()) {
-					if (s != 1) {
-						n.clear();
-						n.emplace(x, y + 1, s + 1);
-						break;
-					}
-					n.emplace(x, y + 1, s);
-				} else if (y + 2 < blizzards.size() && blizzards[y + 1][x] == 0) {
-					n.emplace(x, y + 1, s);
-				}
-			}
-			frontier = std::move(n);
-			++step;
-		}
-		throw std::runtime_error("No solution found");
+		cross(first(), before_exit());
+		cross(before_exit(), first());
+		return cross(first(), before_exit());
 	}
 
 private:
-	void advance_blizzards() {
-		std::vector<std::vector<unsigned char>> n(blizzards.size());
-		n.front().resize(blizzards.front().size(), 0);
-		for (std::size_t i = 1; i + 1 < n.size(); ++i) {
-			const std::size_t up = i == 1 ? n.size() - 2 : i - 1;
-			const std::size_t down = i + 2 == n.size() ? 1 : i + 1;
-			n[i].resize(blizzards.front().size(), 0);
-			for (std::size_t j = 1; j + 1 < n[i].size(); ++j) {
-				const std::size_t left = j == 1 ? n.front().size() - 2 : j - 1;
-				const std::size_t right = j + 2 == n.front().size() ? 1 : j + 1;
-				if (blizzards[down][j] & 1)
-					n[i][j] |= 1;
-				if (blizzards[up][j] & 2)
-					n[i][j] |= 2;
-				if (blizzards[i][right] & 4)
-					n[i][j] |= 4;
-				if (blizzards[i][left] & 8)
-					n[i][j] |= 8;
-			}
+	struct cell {
+		std::size_t x;
+		std::size_t y;
+	};
+
+	[[nodiscard]] static std::size_t inside(const std::size_t n) {
+		if (n < 3)
+			throw std::runtime_error("No room for the valley");
+		return n - 2;
+	}
+
+	[[nodiscard]] static constexpr cell first() noexcept { return {0, 0}; }
+
+	[[nodiscard]] cell before_exit() const noexcept {
+		return {up.width() - 1, up.height() - 1};
+	}
+
+	/*
+	 * Goes from the entrance or the exit, waiting there as long as needed,
+	 * to the other one, reached the minute after the cell next to it, and
+	 * returns the minute of arrival.
+	 */
+	std::uintmax_t cross(const cell entry, const cell target) {
+		frontier.clear();
+		for (;;) {
+			advance_blizzards();
+			++minute;
+			if (frontier.test(target.x, target.y))
+				return minute;
+			next.spread(frontier);
+			next.set(entry.x, entry.y);
+			next &= free;
+			std::swap(frontier, next);
 		}
-		n.back().resize(blizzards.front().size(), 0);
-		blizzards = std::move(n);
 	}
 
-	std::vector<std::vector<unsigned char>> blizzards;
-	std::size_t xo;
-	std::size_t yo;
+	void advance_blizzards() noexcept {
+		up.rotate_up();
+		down.rotate_down();
+		left.rotate_left();
+		right.rotate_right();
+		free = up;
+		free |= down;
+		free |= left;
+		free |= right;
+		free.flip();
+	}
+
+	bit_grid up;
+	bit_grid down;
+	bit_grid left;
+	bit_grid right;
+	bit_grid free;
+	bit_grid frontier;
+	bit_grid next;
+	std::uintmax_t minute = 0;
 };
 
 static std::vector<std::string> get_lines(std::istream& in)
@@ -171,11 +127,31 @@ static std::vector<std::string> get_lines(std::istream& in)
 		if (!line.empty())
 			lines.emplace_back(std::move(line));
 	}
+	if (lines.empty())
+		throw std::runtime_error("Empty");
+	for (auto it = lines.cbegin() + 1; it != lines.cend(); ++it) {
+		if (it->size() != lines.front().size())
+			throw std::runtime_error("Inconsistent width");
+	}
 	return lines;
 }
 
-template<> output_pair day<24>(std::istream& in)
+class solution final : public parsed_input {
+public:
+	explicit solution(std::istream& in) : lines{get_lines(in)} {}
+	puzzle_output part1() override { return state(lines).distance_exit(); }
+
+	puzzle_output part2() override {
+		return state(lines).distance_three();
+	}
+
+private:
+	std::vector<std::string> lines;
+};
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<24>(std::istream& in)
 {
-	const std::vector<std::string> lines = get_lines(in);
-	return {state(lines).distance_exit(), state(lines).distance_three()};
+	return std::make_unique<solution>(in);
 }
@@ -1,7 +1,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <execution>
-#include <istream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -32,11 +32,11 @@ constexpr std::uintmax_t parse_snafu(std::string_view s)
 	return static_cast<std::uintmax_t>(acc);
 }
 
-static std::uintmax_t sum_snafu(std::istream& in)
+static std::uintmax_t sum_snafu(std::string_view in)
 {
 	std::uintmax_t acc = 0;
-	std::string line;
-	while (std::getline(in, line)) {
+	while (!in.empty()) {
+		const std::string_view line = next_line(in);
 		if (line.empty())
 			continue;
 		acc += parse_snafu(line);
@@ -57,9 +57,25 @@ static std::string to_snafu(std::uintmax_t n)
 	return result;
 }
 
-template<> output_pair day<25>(std::istream& in)
+namespace {
+
+class solution final : public parsed_input {
+public:
+	explicit solution(std::string_view in) : sum{sum_snafu(in)} {}
+	puzzle_output part1() override { return to_snafu(sum); }
+
+	puzzle_output part2() override {
+		using namespace std::literals;
+		return "FREE"s;
+	}
+
+private:
+	std::uintmax_t sum;
+};
+
+}
+
+template<> std::unique_ptr<parsed_input> parse<25>(std::string_view in)
 {
-	using namespace std::literals;
-	const std::uintmax_t s = sum_snafu(in);
-	return {to_snafu(s), "FREE"s};
+	return std::make_unique<solution>(in);
 }
@@ -1,63 +1,47 @@
-// FIXME: performance issues when multithreading (possible false sharing)
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <future>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
 #include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
 
-#include "common.h"
-
-template<> output_pair day<1>(std::istream& in);
-template<> output_pair day<2>(std::istream& in);
-template<> output_pair day<3>(std::istream& in);
-template<> output_pair day<4>(std::istream& in);
-template<> output_pair day<5>(std::istream& in);
-template<> output_pair day<6>(std::istream& in);
-template<> output_pair day<7>(std::istream& in);
-template<> output_pair day<8>(std::istream& in);
-template<> output_pair day<9>(std::istream& in);
-template<> output_pair day<10>(std::istream& in);
-template<> output_pair day<11>(std::istream& in);
-template<> output_pair day<12>(std::istream& in);
-template<> output_pair day<13>(std::istream& in);
-template<> output_pair day<14>(std::istream& in);
-template<> output_pair day<15>(std::istream& in);
-template<> output_pair day<16>(std::istream& in);
-template<> output_pair day<17>(std::istream& in);
-template<> output_pair day<18>(std::istream& in);
-template<> output_pair day<19>(std::istream& in);
-template<> output_pair day<20>(std::istream& in);
-template<> output_pair day<21>(std::istream& in);
-template<> output_pair day<22>(std::istream& in);
-template<> output_pair day<23>(std::istream& in);
-template<> output_pair day<24>(std::istream& in);
-template<> output_pair day<25>(std::istream& in);
-
-static constexpr output_pair (*days[])(std::istream&) = {
-	day<1>, day<2>, day<3>, day<4>, day<5>, day<6>, day<7>, day<8>, day<9>,
-	day<10>, day<11>, day<12>, day<13>, day<14>, day<15>, day<16>, day<17>,
-	day<18>, day<19>, day<20>, day<21>, day<22>, day<23>, day<24>, day<25>
-};
-
-static constexpr auto ndays = std::size(days);
-
-static constexpr unsigned job_time[] = {
-	3, 4, 5, 3, 3, 4, 5, 3, 12, 3, 24, 9, 26, 820, 5387, 5463,
-	37, 28, 608, 215, 37, 14, 17639, 747, 3
-};
+#include <unistd.h>
 
-static_assert(std::size(job_time) == ndays,
-              "days and time have different sizes");
+#include "affinity.h"
+#include "alloc_profile.h"
+#include "baseline.h"
+#include "benchmark.h"
+#include "common.h"
+#include "cost_model.h"
+#include "counters.h"
+#include "exec_context.h"
+#include "generators.h"
+#include "mapped_file.h"
+#include "prefetch.h"
+#include "registry.h"
+#include "result_cache.h"
+#include "result_slot.h"
+#include "server.h"
+#include "thread_pool.h"
+#include "watchdog.h"
 
-static std::size_t parse(std::string arg)
+static std::size_t parse_day(std::string arg)
 {
 	std::size_t r;
 	std::istringstream s{std::move(arg)};
@@ -68,86 +52,958 @@ static std::size_t parse(std::string arg)
 	return r;
 }
 
-constexpr std::vector<std::uint_fast32_t> make_jobs(const unsigned num_threads)
+static unsigned parse_count(std::string arg, const unsigned min)
 {
-	if (num_threads != 2)
-		throw std::invalid_argument("Wrong number of threads");
-	return {0b1101111111111111111111111, 0b10000000000000000000000};
+	unsigned r;
+	std::istringstream s{std::move(arg)};
+	if (!(s >> r) || r < min) {
+		std::ostringstream e;
+		e << "Expected a number no less than " << min;
+		throw std::invalid_argument(e.str());
+	}
+	return r;
 }
 
-static std::pair<output_pair, std::chrono::milliseconds>
-make_exception_output(const std::exception& e) noexcept
+static constexpr char cost_file[] = "advent-costs";
+
+struct stage_times {
+	[[nodiscard]] std::chrono::nanoseconds total() const noexcept {
+		return parse + part1 + part2;
+	}
+
+	std::chrono::nanoseconds parse;
+	std::chrono::nanoseconds part1;
+	std::chrono::nanoseconds part2;
+};
+
+struct day_result {
+	output_pair output;
+	stage_times time;
+	alloc_stats allocs;
+	counter_values counters;
+	bool failed;
+	bool cached;
+	// Where the day ended, or -1 if unknown
+	int cpu;
+};
+
+static output_pair
+run_stages(const std::size_t d, const std::string_view in, exec_context& ctx,
+           stage_times& t)
+{
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+	const arena_scope arena;
+	const std::unique_ptr<parsed_input> p = days[d].parse(in);
+	p->set_context(ctx);
+	const auto parsed = clock::now();
+	// Every day can at least be stopped between stages
+	ctx.check_cancelled();
+	puzzle_output first = p->part1();
+	const auto solved1 = clock::now();
+	ctx.check_cancelled();
+	puzzle_output second = p->part2();
+	const auto solved2 = clock::now();
+	t = {parsed - start, solved1 - parsed, solved2 - solved1};
+	return {std::move(first), std::move(second)};
+}
+
+static day_result make_exception_output(const std::exception& e) noexcept
 {
 	using namespace std::literals;
-	return {output_pair{std::string(e.what()), ""s}, 0ms};
+	return {output_pair{std::string(e.what()), ""s}, {0ns, 0ns, 0ns},
+	        {0, 0, 0}, {}, true, false, -1};
+}
+
+static std::string input_name(const std::size_t d)
+{
+	return "input-" + std::to_string(d + 1);
+}
+
+static std::vector<std::string> input_names()
+{
+	std::vector<std::string> names;
+	for (std::size_t d = 0; d < ndays; ++d)
+		names.push_back(input_name(d));
+	return names;
 }
 
-static void
-work(std::uint_fast32_t jobs,
-     std::span<std::promise<std::pair<output_pair, std::chrono::milliseconds>>,
-               ndays> out)
+// Order in which days are likely to start: each worker's first, second…
+static std::vector<std::size_t>
+start_order(const std::vector<std::vector<std::size_t>>& schedule)
+{
+	std::vector<std::size_t> order;
+	for (std::size_t i = 0;; ++i) {
+		const std::size_t n = order.size();
+		for (const auto& jobs : schedule) {
+			if (i < jobs.size())
+				order.push_back(jobs[i]);
+		}
+		if (order.size() == n)
+			return order;
+	}
+}
+
+static std::string to_string(const puzzle_output& o)
+{
+	std::ostringstream s;
+	s << o;
+	return std::move(s).str();
+}
+
+static day_result work(const std::size_t d, const exec_context& pool_ctx,
+                       input_prefetch& inputs, const bool counters,
+                       const result_cache *const cache,
+                       watchdog *const budget) noexcept
 {
 	using namespace std::literals;
-	for (unsigned d = 0; d < ndays; ++d) {
-		if ((jobs & (std::uint_fast32_t{1} << d)) == 0)
-			continue;
+	try {
+		std::optional<watchdog::timer> timer;
+		exec_context ctx = pool_ctx;
+		if (budget)
+			ctx = pool_ctx.with_stop(timer.emplace(*budget).token());
+		const std::unique_ptr<mapped_file> file = inputs.take(d);
+		const mapped_file& input = *file;
+		if (cache) {
+			if (auto hit = cache->find(d, input.view())) {
+				return {output_pair{std::move(hit->first),
+				                    std::move(hit->second)},
+				        {0ns, 0ns, 0ns}, {0, 0, 0}, {}, false,
+				        true, current_cpu()};
+			}
+		}
+		stage_times t;
+		std::optional<perf_counters> pc;
+		if (counters)
+			pc.emplace();
+		// Counters are per thread, so other days running do not count
+		reset_alloc_stats();
+		if (pc)
+			pc->start();
+		output_pair p = run_stages(d, input.view(), ctx, t);
+		const counter_values c = pc ? pc->stop() : counter_values{};
+		if (cache && !cache->store(d, input.view(),
+		                           {to_string(p.first),
+		                            to_string(p.second)})) [[unlikely]]
+			std::cerr << "Could not cache day " << (d + 1) << std::endl;
+		return {std::move(p), t, thread_alloc_stats(), c, false, false,
+		        current_cpu()};
+	} catch (const cancelled_error&) {
+		const auto ms = std::chrono::duration_cast<
+			std::chrono::milliseconds>(budget->budget());
 		std::ostringstream s;
-		s << "input-" << (d + 1);
-		try {
-			std::ifstream f(s.str());
-			const auto start = std::chrono::steady_clock::now();
-			output_pair p = days[d](f);
-			const auto end = std::chrono::steady_clock::now();
-			const auto t = std::chrono::duration_cast<
-					std::chrono::milliseconds
-				>(end - start);
-			out[d].set_value(std::pair{std::move(p), t});
-		} catch (const std::exception& e) {
-			out[d].set_value(make_exception_output(e));
+		s << "Timed out after " << ms;
+		return make_exception_output(std::runtime_error(s.str()));
+	} catch (const std::exception& e) {
+		return make_exception_output(e);
+	}
+}
+
+static cost_model load_costs()
+{
+	cost_model::duration initial[ndays];
+	std::transform(days.begin(), days.end(), initial,
+	               [](const day_info& d) {
+		               return d.traits.expected_cost;
+	               });
+	cost_model costs{initial};
+	std::ifstream f{cost_file};
+	if (!f)
+		return costs;
+	try {
+		costs.read(f);
+	} catch (const std::exception& e) {
+		std::cerr << cost_file << ": " << e.what() << std::endl;
+		return cost_model{initial};
+	}
+	return costs;
+}
+
+static void save_costs(const cost_model& costs)
+{
+	std::ofstream f{cost_file};
+	costs.write(f);
+	if (!f.flush()) [[unlikely]]
+		std::cerr << "Could not save " << cost_file << std::endl;
+}
+
+// Warns and returns false when the counters cannot be used
+static bool check_counters()
+{
+	const perf_counters probe;
+	if (probe.available())
+		return true;
+	std::cerr << "Hardware counters unavailable: "
+	          << std::strerror(probe.error()) << std::endl;
+	return false;
+}
+
+// Warns and returns nothing when the cache directory cannot be used
+static std::optional<result_cache> open_cache(const std::string_view dir)
+{
+	if (dir.empty())
+		return std::nullopt;
+	try {
+		return std::optional<result_cache>{std::in_place, dir};
+	} catch (const std::exception& e) {
+		std::cerr << "Result cache unavailable: " << e.what()
+		          << std::endl;
+		return std::nullopt;
+	}
+}
+
+/*
+ * Pins each worker to a CPU, chosen by a placement policy ("spread" or
+ * "pack") or from a list of CPUs used in turn. Days then allocate and first
+ * touch their data from a fixed CPU, so that it stays on that CPU's NUMA
+ * node. Warns and returns nothing if the workers could not all be pinned.
+ */
+static std::optional<std::vector<unsigned>>
+pin_workers(thread_pool& pool, const std::string_view how)
+{
+	using namespace std::literals;
+	try {
+		std::vector<unsigned> cpus;
+		if (how == "spread"sv || how == "pack"sv) {
+			const auto policy = how == "spread"sv
+			                    ? placement_policy::spread
+			                    : placement_policy::pack;
+			cpus = cpu_topology::detect().place(pool.size(), policy);
+		} else {
+			const std::vector<unsigned> list = parse_cpu_list(how);
+			if (list.empty())
+				throw std::invalid_argument("Empty CPU list");
+			for (unsigned w = 0; w < pool.size(); ++w)
+				cpus.push_back(list[w % list.size()]);
 		}
+		for (unsigned w = 0; w < pool.size(); ++w)
+			pin_thread(pool.native_handle(w), cpus[w]);
+		return cpus;
+	} catch (const std::exception& e) {
+		std::cerr << "Could not pin workers: " << e.what() << std::endl;
+		return std::nullopt;
 	}
 }
 
-static int run_all_tests(const unsigned num_threads) noexcept
+/*
+ * Solves every day and prints their answers, in day order unless unordered
+ * is set, in which case each day is printed as soon as it is done. The
+ * summary is in day order either way.
+ */
+static int run_all_tests(const unsigned num_threads, bool counters,
+                         const std::string_view cache_dir,
+                         const bool unordered,
+                         const std::chrono::milliseconds budget,
+                         const std::string_view pin) noexcept
 {
 	using namespace std::chrono;
-	const std::vector<std::uint_fast32_t> jobs = make_jobs(num_threads);
-	std::vector<std::thread> workers;
-	workers.reserve(num_threads);
-	std::promise<std::pair<output_pair, milliseconds>> out_promise[ndays];
-	std::future<std::pair<output_pair, milliseconds>> out[ndays];
-	std::chrono::milliseconds durations[ndays];
-	for (unsigned d = 0; d < ndays; ++d)
-		out[d] = out_promise[d].get_future();
-	for (unsigned t = 0; t < num_threads; ++t)
-		workers.emplace_back(work, jobs[t], std::span(out_promise));
-	for (unsigned d = 0; d < ndays; ++d) {
-		auto [p, dur] = out[d].get();
-		durations[d] = std::move(dur);
+	if (counters)
+		counters = check_counters();
+	const std::optional<result_cache> cache = open_cache(cache_dir);
+	const result_cache *const cache_ptr = cache ? &*cache : nullptr;
+	std::optional<watchdog> dog;
+	if (budget > budget.zero())
+		dog.emplace(budget);
+	watchdog *const dog_ptr = dog ? &*dog : nullptr;
+	cost_model costs = load_costs();
+	result_slot<day_result> out[ndays];
+	completion_queue<ndays> done;
+	stage_times durations[ndays];
+	alloc_stats allocs[ndays];
+	counter_values hw[ndays];
+	bool cached[ndays];
+	int cpus[ndays];
+	const auto start = steady_clock::now();
+	thread_pool pool{num_threads};
+	std::optional<std::vector<unsigned>> placement;
+	if (!pin.empty())
+		placement = pin_workers(pool, pin);
+	exec_context ctx{pool};
+	const auto schedule = costs.schedule(num_threads);
+	input_prefetch inputs{input_names(), start_order(schedule),
+	                      num_threads};
+	std::vector<std::vector<thread_pool::task_type>> plan;
+	for (const auto& jobs : schedule) {
+		plan.emplace_back();
+		for (const std::size_t d : jobs)
+			plan.back().emplace_back([=, &out, &done, &ctx, &inputs] {
+				out[d].publish(work(d, ctx, inputs, counters,
+				                    cache_ptr, dog_ptr));
+				done.push(d);
+			});
+	}
+	pool.submit_plan(std::move(plan));
+	for (std::size_t i = 0; i < ndays; ++i) {
+		const std::size_t d = unordered ? done.pop() : i;
+		auto [p, dur, a, c, failed, hit, cpu] = out[d].take();
+		durations[d] = dur;
+		allocs[d] = a;
+		hw[d] = c;
+		cached[d] = hit;
+		cpus[d] = cpu;
+		if (!failed && !hit)
+			costs.update(d, dur.total());
 		std::cout << "Day " << (d + 1) << '\n' << p.first << '\n'
 		          << p.second << '\n' << std::endl;
 	}
-	for (auto& worker : workers)
-		worker.join();
-	std::cout << "Summary:\n";
-	for (unsigned d = 0; d < ndays; ++d)
-		std::cout << (d + 1) << '\t' << durations[d] << '\n';
+	const auto wall = duration_cast<milliseconds>(steady_clock::now()
+	                                              - start);
+	save_costs(costs);
+	std::cout << "Summary (" << num_threads << " threads, " << wall
+	          << " wall time):\n";
+	if (placement) {
+		const cpu_topology topology = cpu_topology::detect();
+		std::cout << "worker\tcpu\tnode\n";
+		for (unsigned w = 0; w < placement->size(); ++w) {
+			const unsigned c = (*placement)[w];
+			std::cout << w << '\t' << c << '\t'
+			          << topology.node_of(c) << '\n';
+		}
+	}
+	std::cout << "day\tparse\tpart 1\tpart 2\ttotal";
+	if constexpr (alloc_profiling)
+		std::cout << "\tallocs\tbytes\tpeak";
+	if (counters)
+		std::cout << '\t' << counter_columns;
+	if (placement)
+		std::cout << "\tcpu";
+	std::cout << '\n';
+	for (unsigned d = 0; d < ndays; ++d) {
+		if (cached[d]) {
+			std::cout << (d + 1) << "\tcached\n";
+			continue;
+		}
+		const stage_times& t = durations[d];
+		std::cout << (d + 1) << '\t'
+		          << duration_cast<microseconds>(t.parse) << '\t'
+		          << duration_cast<microseconds>(t.part1) << '\t'
+		          << duration_cast<microseconds>(t.part2) << '\t'
+		          << duration_cast<microseconds>(t.total());
+		if constexpr (alloc_profiling) {
+			const alloc_stats& a = allocs[d];
+			std::cout << '\t' << a.count << '\t' << a.bytes
+			          << '\t' << a.peak;
+		}
+		if (counters)
+			std::cout << '\t' << hw[d];
+		if (placement)
+			std::cout << '\t' << cpus[d];
+		std::cout << '\n';
+	}
 	std::cout << std::endl;
 	return EXIT_SUCCESS;
 }
 
-int main(int argc, char *argv[])
+// Mean of every counter over the runs, missing if any run lacked it
+static counter_values
+mean_counters(const std::vector<counter_values>& runs) noexcept
 {
-	if (argc == 2 && argv[1][0] == '-' && argv[1][1] == 'a'
-	    && argv[1][2] == 0) {
-		return run_all_tests(2);
-	} else if (argc <= 2) {
-		const std::size_t d = argc > 1 ? parse(argv[1]) : ndays;
-		const auto [p1, p2] = days[d - 1](std::cin);
-		std::cout << p1 << '\n' << p2 << std::endl;
-	} else {
-		std::cerr << "usage: " << (argc >= 1 ? argv[0] : "advent")
-		          << " [day | -a]" << std::endl;
+	counter_values result;
+	for (std::size_t i = 0; i < num_hw_counters; ++i) {
+		std::uint64_t sum = 0;
+		bool complete = !runs.empty();
+		for (const counter_values& r : runs) {
+			complete = complete && r.values[i];
+			sum += r.values[i].value_or(0);
+		}
+		if (complete)
+			result.values[i] = sum / runs.size();
+	}
+	return result;
+}
+
+static std::optional<benchmark_store> load_benchmarks(const std::string& path)
+{
+	benchmark_store store{ndays};
+	std::ifstream f{path};
+	if (!f) {
+		std::cerr << path << ": Could not open" << std::endl;
+		return std::nullopt;
+	}
+	try {
+		store.read(f);
+	} catch (const std::exception& e) {
+		std::cerr << path << ": " << e.what() << std::endl;
+		return std::nullopt;
+	}
+	return store;
+}
+
+// Adds a day to the results already saved in the file, if any
+static bool save_benchmark(const std::string_view path, const std::size_t d,
+                           const day_record& record)
+{
+	const std::string p{path};
+	std::optional<benchmark_store> store{std::in_place, ndays};
+	if (std::filesystem::exists(p))
+		store = load_benchmarks(p);
+	if (!store)
+		return false;
+	store->set(d, record);
+	std::ofstream f{p};
+	store->write(f);
+	if (!f.flush()) [[unlikely]] {
+		std::cerr << "Could not save " << p << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Days run on the calling thread alone unless num_threads is positive
+static int run_benchmark(const std::size_t d, const unsigned reps,
+                         const unsigned warmup, const unsigned num_threads,
+                         const bool counters, const std::string_view save)
+{
+	using namespace std::literals;
+	std::vector<std::chrono::nanoseconds> samples[4];
+	for (auto& v : samples)
+		v.reserve(reps);
+	std::vector<counter_values> hw;
+	std::optional<perf_counters> pc;
+	if (counters && check_counters()) {
+		hw.reserve(reps);
+		pc.emplace();
+	}
+	alloc_stats allocs{0, 0, 0};
+	// Idle workers would only be noise next to a day which cannot use them
+	const bool threaded = num_threads > 0 && days[d].traits.parallel;
+	std::optional<thread_pool> pool;
+	exec_context ctx;
+	if (threaded)
+		ctx = exec_context{pool.emplace(num_threads)};
+	try {
+		const mapped_file input{input_name(d)};
+		stage_times t;
+		for (unsigned r = 0; r < warmup; ++r)
+			(void) run_stages(d, input.view(), ctx, t);
+		for (unsigned r = 0; r < reps; ++r) {
+			reset_alloc_stats();
+			if (pc)
+				pc->start();
+			(void) run_stages(d, input.view(), ctx, t);
+			if (pc)
+				hw.push_back(pc->stop());
+			const alloc_stats a = thread_alloc_stats();
+			allocs.count += a.count;
+			allocs.bytes += a.bytes;
+			if (a.peak > allocs.peak)
+				allocs.peak = a.peak;
+			samples[0].push_back(t.parse);
+			samples[1].push_back(t.part1);
+			samples[2].push_back(t.part2);
+			samples[3].push_back(t.total());
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "Day " << (d + 1) << ": " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::vector<sample_summary> summaries;
+	for (auto& v : samples)
+		summaries.push_back(summarize(std::move(v)));
+	std::cout << "Day " << days[d].number << " (" << reps << " runs, "
+	          << warmup << " warmup, nanoseconds)\n";
+	if (!days[d].traits.independent_parts)
+		std::cout << "Part 2 continues from the state of part 1\n";
+	if (num_threads > 0 && !threaded)
+		std::cout << "Runs on one thread, the day has no parallel work\n";
+	print_summaries(std::cout, stage_names, summaries);
+	const counter_values mean_hw = pc ? mean_counters(hw) : counter_values{};
+	if (pc) {
+		std::cout << "Counters (mean per run)\n" << counter_columns
+		          << '\n' << mean_hw << '\n';
+	}
+	std::cout << std::flush;
+	if (save.empty())
+		return EXIT_SUCCESS;
+	day_record record{reps, {}, {allocs.count / reps, allocs.bytes / reps,
+	                             allocs.peak}, mean_hw};
+	for (std::size_t i = 0; i < num_stages; ++i)
+		record.stages[i] = {summaries[i].median, summaries[i].stddev};
+	return save_benchmark(save, d, record) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * Compares the median time of every stage of the days benchmarked in both
+ * files, and fails if any of them got slower by more than threshold percent.
+ */
+static int run_compare(const std::string_view base_path,
+                       const std::string_view new_path,
+                       const unsigned threshold)
+{
+	const auto base = load_benchmarks(std::string(base_path));
+	const auto now = load_benchmarks(std::string(new_path));
+	if (!base || !now)
+		return EXIT_FAILURE;
+	bool regressed = false;
+	std::cout << "Median times (nanoseconds)\n"
+	          << "day\tstage\tbase\tnew\tchange\n";
+	for (std::size_t d = 0; d < ndays; ++d) {
+		if (!base->get(d) || !now->get(d))
+			continue;
+		const day_record& b = *base->get(d);
+		const day_record& n = *now->get(d);
+		for (std::size_t i = 0; i < num_stages; ++i) {
+			const stage_delta delta = compare_stage(
+				b.stages[i], b.runs, n.stages[i], n.runs,
+				threshold / 100.0);
+			std::cout << (d + 1) << '\t' << stage_names[i] << '\t'
+			          << b.stages[i].median.count() << '\t'
+			          << n.stages[i].median.count() << '\t'
+			          << std::showpos << std::fixed
+			          << std::setprecision(1) << delta.change * 100
+			          << std::noshowpos << '%';
+			if (delta.v == verdict::slower)
+				std::cout << "\tslower";
+			else if (delta.v == verdict::faster)
+				std::cout << "\tfaster";
+			std::cout << '\n';
+			regressed = regressed || delta.v == verdict::slower;
+		}
+		if (b.allocs.count != n.allocs.count) {
+			std::cout << (d + 1) << "\tallocs\t" << b.allocs.count
+			          << '\t' << n.allocs.count << '\n';
+		}
+	}
+	std::cout << std::flush;
+	return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Regular files of a directory, sorted by name
+static std::vector<std::filesystem::path>
+list_inputs(const std::filesystem::path& dir)
+{
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator{dir}) {
+		if (entry.is_regular_file())
+			files.push_back(entry.path());
+	}
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+/*
+ * Solves day d on every file in dir and prints one line per file as soon as
+ * it is solved. At most twice as many files as threads are mapped and solved
+ * at once, which bounds the memory held by the parsed inputs.
+ */
+static int run_batch(const std::size_t d, const std::string_view dir,
+                     const unsigned num_threads) noexcept
+{
+	using namespace std::chrono;
+	std::vector<std::filesystem::path> files;
+	try {
+		files = list_inputs(dir);
+	} catch (const std::filesystem::filesystem_error& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::counting_semaphore<> slots{2 * std::ptrdiff_t{num_threads}};
+	std::mutex out_mutex;
+	std::atomic<std::size_t> failures = 0;
+	const auto start = steady_clock::now();
+	{
+		thread_pool pool{num_threads};
+		std::optional<exec_context> pool_ctx;
+		// Inputs are solved side by side; only parallel days also split one
+		exec_context& ctx = ::days[d].traits.parallel
+		                    ? pool_ctx.emplace(pool) : exec_context::serial();
+		for (const std::filesystem::path& f : files) {
+			slots.acquire();
+			pool.submit([d, &f, &ctx, &slots, &out_mutex,
+			             &failures] {
+				std::ostringstream line;
+				std::ostream* out = &std::cout;
+				try {
+					const mapped_file input{f.string()};
+					stage_times t;
+					const auto [p1, p2] = run_stages(
+						d, input.view(), ctx, t);
+					line << f.filename().string() << '\t'
+					     << p1 << '\t' << p2 << '\t'
+					     << t.total().count() << '\n';
+				} catch (const std::exception& e) {
+					line << f.filename().string() << ": "
+					     << e.what() << '\n';
+					out = &std::cerr;
+					++failures;
+				}
+				{
+					const std::lock_guard lock{out_mutex};
+					*out << line.view() << std::flush;
+				}
+				slots.release();
+			});
+		}
+	}
+	const auto wall = duration_cast<nanoseconds>(steady_clock::now()
+	                                             - start);
+	const double seconds = duration<double>(wall).count();
+	std::cerr << files.size() << " inputs, " << failures << " failed, "
+	          << duration_cast<milliseconds>(wall) << " wall time ("
+	          << (seconds > 0 ? static_cast<double>(files.size()) / seconds
+	                          : 0.0)
+	          << " inputs/s)" << std::endl;
+	return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Formats both answers, or the error, of day d (counted from 1) on the input
+static answer solve(const std::uint32_t d, const std::string_view input,
+                    exec_context& ctx) noexcept
+{
+	try {
+		if (d < 1 || d > ndays)
+			throw std::invalid_argument("Day not in range");
+		const auto [p1, p2] = days[d - 1].solve(input, ctx);
+		return {false, to_string(p1), to_string(p2)};
+	} catch (const std::exception& e) {
+		return {true, e.what(), {}};
+	}
+}
+
+static int run_server(const std::string_view path, const unsigned num_threads)
+{
+	try {
+		thread_pool pool{num_threads};
+		exec_context ctx{pool};
+		serve(std::string(path), pool,
+		      [&ctx](const std::uint32_t d, const std::string_view in) {
+			      return solve(d, in, ctx);
+		      });
+	} catch (const std::exception& e) {
+		std::cerr << path << ": " << e.what() << std::endl;
+	}
+	return EXIT_FAILURE;
+}
+
+/*
+ * Holds the standard input, mapped when possible. Pipes and terminals cannot
+ * be mapped and are read whole instead.
+ */
+class standard_input {
+public:
+	standard_input() {
+		if (mapped_file::is_mappable(STDIN_FILENO)) {
+			text = map.emplace(STDIN_FILENO).view();
+		} else {
+			std::ostringstream s;
+			s << std::cin.rdbuf();
+			buffer = std::move(s).str();
+			text = buffer;
+		}
+	}
+
+	[[nodiscard]] std::string_view view() const noexcept { return text; }
+
+private:
+	std::optional<mapped_file> map{};
+	std::string buffer{};
+	std::string_view text{};
+};
+
+static int run_client(const std::string_view path, const std::size_t d)
+{
+	try {
+		const standard_input input;
+		const answer a = request(std::string(path),
+		                         static_cast<std::uint32_t>(d),
+		                         input.view());
+		if (a.failed) {
+			std::cerr << "Day " << d << ": " << a.first << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << a.first << '\n' << a.second << std::endl;
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
 		return EXIT_FAILURE;
 	}
+	return EXIT_SUCCESS;
+}
+
+static const input_generator* generator_of(const std::size_t d)
+{
+	const input_generator* const g = find_generator(d);
+	if (!g)
+		std::cerr << "Day " << (d + 1) << " has no input generator"
+		          << std::endl;
+	return g;
+}
+
+static int run_generator(const std::size_t d, const std::size_t size,
+                         const std::uint64_t seed)
+{
+	const input_generator* const g = generator_of(d);
+	if (!g)
+		return EXIT_FAILURE;
+	std::cout << generate_input(*g, size, seed) << std::flush;
+	return EXIT_SUCCESS;
+}
+
+/*
+ * Times day d on generated inputs from the size of a real input up to
+ * max_scale times that, doubling each time, and fits the exponent of the
+ * growth of the median time of each stage.
+ */
+static int run_scaling(const std::size_t d, const unsigned reps,
+                       const unsigned max_scale, const unsigned num_threads,
+                       const std::uint64_t seed)
+{
+	using namespace std::literals;
+	const input_generator* const g = generator_of(d);
+	if (!g)
+		return EXIT_FAILURE;
+	std::optional<thread_pool> pool;
+	exec_context ctx;
+	if (num_threads > 0 && days[d].traits.parallel)
+		ctx = exec_context{pool.emplace(num_threads)};
+	std::vector<double> sizes;
+	std::vector<double> medians[4];
+	std::cout << "Day " << (d + 1) << " (" << reps
+	          << " runs per size, median nanoseconds)\n"
+	          << g->unit << "\tparse\tpart 1\tpart 2\ttotal\n";
+	for (unsigned scale = 1; scale <= max_scale; scale *= 2) {
+		const std::size_t size = g->real_size * scale;
+		const std::string input = generate_input(*g, size, seed);
+		std::vector<std::chrono::nanoseconds> samples[4];
+		try {
+			stage_times t;
+			(void) run_stages(d, input, ctx, t);
+			for (unsigned r = 0; r < reps; ++r) {
+				(void) run_stages(d, input, ctx, t);
+				samples[0].push_back(t.parse);
+				samples[1].push_back(t.part1);
+				samples[2].push_back(t.part2);
+				samples[3].push_back(t.total());
+			}
+		} catch (const std::exception& e) {
+			std::cerr << "Size " << size << ": " << e.what()
+			          << std::endl;
+			return EXIT_FAILURE;
+		}
+		sizes.push_back(static_cast<double>(size));
+		std::cout << size;
+		for (std::size_t i = 0; i < std::size(samples); ++i) {
+			const auto m = summarize(std::move(samples[i])).median;
+			std::cout << '\t' << m.count();
+			// Logarithms need times above zero
+			medians[i].push_back(std::max(1.0,
+			                     static_cast<double>(m.count())));
+		}
+		std::cout << std::endl;
+	}
+	if (sizes.size() >= 2) {
+		std::cout << "exponent" << std::fixed << std::setprecision(2);
+		for (const auto& m : medians)
+			std::cout << '\t' << fit_exponent(sizes, m);
+		std::cout << std::endl;
+	}
+	return EXIT_SUCCESS;
+}
+
+struct options {
+	enum class run_mode {
+		single, all, benchmark, compare, batch, serve, client,
+		generate, scaling
+	};
+
+	// Threads asked for, or as many as the hardware supports
+	[[nodiscard]] unsigned thread_count() const noexcept {
+		const unsigned t = threads > 0 ? threads
+		                   : std::thread::hardware_concurrency();
+		return t > 0 ? t : 1;
+	}
+
+	run_mode mode = run_mode::single;
+	std::size_t day = ndays;
+	unsigned threads = 0;
+	unsigned repetitions = 10;
+	unsigned warmup = 1;
+	unsigned size = 0;
+	unsigned max_scale = 16;
+	std::uint64_t seed = 2022;
+	bool counters = false;
+	bool unordered = false;
+	unsigned budget = 0;
+	unsigned threshold = 5;
+	std::string_view pin{};
+	std::string_view cache{};
+	std::string_view save{};
+	std::string_view path{};
+	std::string_view results{};
+};
+
+static std::optional<options> parse_options(std::span<char*> args)
+{
+	using namespace std::literals;
+	options o;
+	bool has_day = false;
+	for (auto it = args.begin(); it != args.end(); ++it) {
+		const std::string_view a = *it;
+		const bool has_value = it + 1 != args.end();
+		if (a == "-a"sv && o.mode == options::run_mode::single
+		    && !has_day) {
+			o.mode = options::run_mode::all;
+		} else if (a == "-b"sv && o.mode == options::run_mode::single
+		           && !has_day && has_value) {
+			o.mode = options::run_mode::benchmark;
+			o.day = parse_day(*++it);
+			has_day = true;
+		} else if (a == "--compare"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && it + 2 < args.end()) {
+			o.mode = options::run_mode::compare;
+			o.path = *++it;
+			o.results = *++it;
+			has_day = true;
+		} else if (a == "-t"sv && o.mode == options::run_mode::compare
+		           && has_value) {
+			o.threshold = parse_count(*++it, 0);
+		} else if (a == "--save"sv
+		           && o.mode == options::run_mode::benchmark
+		           && has_value) {
+			o.save = *++it;
+		} else if (a == "--batch"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && it + 2 < args.end()) {
+			o.mode = options::run_mode::batch;
+			o.day = parse_day(*++it);
+			o.path = *++it;
+			has_day = true;
+		} else if (a == "--serve"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && has_value) {
+			o.mode = options::run_mode::serve;
+			o.path = *++it;
+			has_day = true;
+		} else if (a == "--client"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && it + 2 < args.end()) {
+			o.mode = options::run_mode::client;
+			o.path = *++it;
+			o.day = parse_day(*++it);
+			has_day = true;
+		} else if (a == "--generate"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && it + 2 < args.end()) {
+			o.mode = options::run_mode::generate;
+			o.day = parse_day(*++it);
+			o.size = parse_count(*++it, 1);
+			has_day = true;
+		} else if (a == "--scaling"sv
+		           && o.mode == options::run_mode::single
+		           && !has_day && has_value) {
+			o.mode = options::run_mode::scaling;
+			o.day = parse_day(*++it);
+			has_day = true;
+		} else if (a == "-m"sv && o.mode == options::run_mode::scaling
+		           && has_value) {
+			o.max_scale = parse_count(*++it, 2);
+		} else if (a == "-s"sv
+		           && (o.mode == options::run_mode::generate
+		               || o.mode == options::run_mode::scaling)
+		           && has_value) {
+			o.seed = parse_count(*++it, 0);
+		} else if (a == "-j"sv && o.mode != options::run_mode::single
+		           && o.mode != options::run_mode::compare
+		           && o.mode != options::run_mode::client
+		           && o.mode != options::run_mode::generate
+		           && has_value) {
+			o.threads = parse_count(*++it, 1);
+		} else if (a == "-r"sv
+		           && (o.mode == options::run_mode::benchmark
+		               || o.mode == options::run_mode::scaling)
+		           && has_value) {
+			o.repetitions = parse_count(*++it, 1);
+		} else if (a == "-w"sv
+		           && o.mode == options::run_mode::benchmark
+		           && has_value) {
+			o.warmup = parse_count(*++it, 0);
+		} else if (a == "--budget"sv && o.mode == options::run_mode::all
+		           && has_value) {
+			o.budget = parse_count(*++it, 1);
+		} else if (a == "--pin"sv && o.mode == options::run_mode::all
+		           && has_value) {
+			o.pin = *++it;
+		} else if (a == "--unordered"sv
+		           && o.mode == options::run_mode::all) {
+			o.unordered = true;
+		} else if (a == "--cache"sv && o.mode == options::run_mode::all
+		           && has_value) {
+			o.cache = *++it;
+		} else if (a == "--counters"sv
+		           && (o.mode == options::run_mode::all
+		               || o.mode == options::run_mode::benchmark)) {
+			o.counters = true;
+		} else if (o.mode == options::run_mode::single && !has_day
+		           && !a.starts_with('-')) {
+			o.day = parse_day(std::string(a));
+			has_day = true;
+		} else {
+			return std::nullopt;
+		}
+	}
+	return o;
+}
+
+static int usage(const char *name)
+{
+	std::cerr << "usage: " << name << " [day | -a [-j threads] [--counters]"
+	          << " [--cache directory] [--unordered] [--budget ms]"
+	          << " [--pin spread|pack|cpus]"
+	          << " | -b day [-r reps] [-w warmup] [-j threads] [--counters]"
+	          << " [--save file] | --compare baseline results [-t percent]"
+	          << " | --batch day directory [-j threads]"
+	          << " | --serve socket [-j threads] | --client socket day"
+	          << " | --generate day size [-s seed]"
+	          << " | --scaling day [-r reps] [-m max-scale] [-j threads]"
+	          << " [-s seed]]"
+	          << std::endl;
+	return EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *name = argc >= 1 ? argv[0] : "advent";
+	const std::span<char*> args{argv + (argc >= 1),
+	                            argc > 1 ? std::size_t(argc - 1) : 0};
+	std::optional<options> opt;
+	try {
+		opt = parse_options(args);
+	} catch (const std::invalid_argument& e) {
+		std::cerr << e.what() << std::endl;
+	} catch (const std::out_of_range& e) {
+		std::cerr << e.what() << std::endl;
+	}
+	if (!opt)
+		return usage(name);
+	switch (opt->mode) {
+	case options::run_mode::all:
+		return run_all_tests(opt->thread_count(), opt->counters,
+		                     opt->cache, opt->unordered,
+		                     std::chrono::milliseconds{opt->budget},
+		                     opt->pin);
+	case options::run_mode::benchmark:
+		return run_benchmark(opt->day - 1, opt->repetitions,
+		                     opt->warmup, opt->threads, opt->counters,
+		                     opt->save);
+	case options::run_mode::compare:
+		return run_compare(opt->path, opt->results, opt->threshold);
+	case options::run_mode::batch:
+		return run_batch(opt->day - 1, opt->path,
+		                 opt->thread_count());
+	case options::run_mode::serve:
+		return run_server(opt->path, opt->thread_count());
+	case options::run_mode::client:
+		return run_client(opt->path, opt->day);
+	case options::run_mode::generate:
+		return run_generator(opt->day - 1, opt->size, opt->seed);
+	case options::run_mode::scaling:
+		return run_scaling(opt->day - 1, opt->repetitions,
+		                   opt->max_scale, opt->threads, opt->seed);
+	case options::run_mode::single:
+		break;
+	}
+	const standard_input input;
+	const auto [p1, p2] = days[opt->day - 1].solve(input.view(),
+	                                              exec_context::serial());
+	std::cout << p1 << '\n' << p2 << std::endl;
 }
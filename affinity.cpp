@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "affinity.h"
+
+static unsigned parse_cpu(const std::string_view s)
+{
+	unsigned cpu;
+	const auto [end, e] = std::from_chars(s.data(), s.data() + s.size(),
+	                                      cpu);
+	if (e != std::errc{} || end != s.data() + s.size()) [[unlikely]]
+		throw std::invalid_argument("Bad CPU list");
+	return cpu;
+}
+
+std::vector<unsigned> parse_cpu_list(std::string_view list)
+{
+	std::vector<unsigned> cpus;
+	while (!list.empty() && list.back() == '\n')
+		list.remove_suffix(1);
+	while (!list.empty()) {
+		const std::size_t comma = list.find(',');
+		const std::string_view range = list.substr(0, comma);
+		list.remove_prefix(comma == list.npos ? list.size()
+		                                      : comma + 1);
+		const std::size_t dash = range.find('-');
+		const unsigned first = parse_cpu(range.substr(0, dash));
+		const unsigned last = dash == range.npos
+		                      ? first : parse_cpu(range.substr(dash + 1));
+		if (last < first) [[unlikely]]
+			throw std::invalid_argument("Bad CPU list");
+		for (unsigned c = first; c <= last; ++c)
+			cpus.push_back(c);
+	}
+	return cpus;
+}
+
+#ifdef __linux__
+static std::vector<unsigned> allowed_cpus()
+{
+	cpu_set_t set;
+	if (::sched_getaffinity(0, sizeof set, &set) != 0) [[unlikely]]
+		throw std::system_error(errno, std::generic_category(),
+		                        "sched_getaffinity");
+	std::vector<unsigned> cpus;
+	for (unsigned c = 0; c < CPU_SETSIZE; ++c) {
+		if (CPU_ISSET(c, &set))
+			cpus.push_back(c);
+	}
+	return cpus;
+}
+
+cpu_topology cpu_topology::detect()
+{
+	namespace fs = std::filesystem;
+	using namespace std::literals;
+	const std::vector<unsigned> allowed = allowed_cpus();
+	cpu_topology t;
+	std::error_code e;
+	for (const auto& entry :
+	     fs::directory_iterator{"/sys/devices/system/node", e}) {
+		const std::string name = entry.path().filename().string();
+		// substr would throw on a name shorter than the prefix
+		if (!name.starts_with("node"sv))
+			continue;
+		const std::string_view digits = std::string_view{name}.substr(4);
+		if (digits.empty()
+		    || !std::all_of(digits.begin(), digits.end(), [](char c) {
+			    return '0' <= c && c <= '9';
+		    }))
+			continue;
+		std::ifstream f{entry.path() / "cpulist"};
+		std::string line;
+		std::getline(f, line);
+		std::vector<unsigned> cpus;
+		for (const unsigned c : parse_cpu_list(line)) {
+			if (std::binary_search(allowed.begin(), allowed.end(), c))
+				cpus.push_back(c);
+		}
+		if (!cpus.empty())
+			t.nodes.push_back({parse_cpu(digits), std::move(cpus)});
+	}
+	std::sort(t.nodes.begin(), t.nodes.end(),
+	          [](const numa_node& a, const numa_node& b) {
+		          return a.id < b.id;
+	          });
+	// Without NUMA information, all CPUs are taken as one node
+	if (t.nodes.empty())
+		t.nodes.push_back({0, allowed});
+	return t;
+}
+
+void pin_thread(const std::thread::native_handle_type thread,
+                const unsigned cpu)
+{
+	if (cpu >= CPU_SETSIZE) [[unlikely]]
+		throw std::system_error(EINVAL, std::generic_category(),
+		                        "CPU number too high");
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	const int e = ::pthread_setaffinity_np(thread, sizeof set, &set);
+	if (e != 0) [[unlikely]]
+		throw std::system_error(e, std::generic_category(),
+		                        "pthread_setaffinity_np");
+}
+
+int current_cpu() noexcept
+{
+	return ::sched_getcpu();
+}
+#else
+cpu_topology cpu_topology::detect()
+{
+	const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned> cpus(n);
+	for (unsigned c = 0; c < n; ++c)
+		cpus[c] = c;
+	return {{{0, std::move(cpus)}}};
+}
+
+void pin_thread(std::thread::native_handle_type, unsigned)
+{
+	throw std::system_error(ENOSYS, std::generic_category(),
+	                        "Pinning threads is not supported");
+}
+
+int current_cpu() noexcept
+{
+	return -1;
+}
+#endif
+
+int cpu_topology::node_of(const unsigned cpu) const noexcept
+{
+	for (const numa_node& n : nodes) {
+		if (std::find(n.cpus.begin(), n.cpus.end(), cpu) != n.cpus.end())
+			return static_cast<int>(n.id);
+	}
+	return -1;
+}
+
+std::vector<unsigned>
+cpu_topology::place(const unsigned workers, const placement_policy policy)
+	const
+{
+	std::vector<unsigned> order;
+	if (policy == placement_policy::pack) {
+		for (const numa_node& n : nodes)
+			order.insert(order.end(), n.cpus.begin(), n.cpus.end());
+	} else {
+		std::size_t longest = 0;
+		for (const numa_node& n : nodes)
+			longest = std::max(longest, n.cpus.size());
+		for (std::size_t i = 0; i < longest; ++i) {
+			for (const numa_node& n : nodes) {
+				if (i < n.cpus.size())
+					order.push_back(n.cpus[i]);
+			}
+		}
+	}
+	if (order.empty()) [[unlikely]]
+		throw std::runtime_error("No CPU to run on");
+	std::vector<unsigned> cpus(workers);
+	for (unsigned w = 0; w < workers; ++w)
+		cpus[w] = order[w % order.size()];
+	return cpus;
+}
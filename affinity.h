@@ -0,0 +1,43 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef AFFINITY_H
+#define AFFINITY_H
+#include <string_view>
+#include <thread>
+#include <vector>
+
+enum class placement_policy {
+	spread, // round-robin over NUMA nodes, for memory bandwidth
+	pack    // fill one node before the next, for shared caches
+};
+
+struct numa_node {
+	unsigned id;
+	std::vector<unsigned> cpus{};
+};
+
+// CPUs this process may run on, grouped by NUMA node
+struct cpu_topology {
+	[[nodiscard]] static cpu_topology detect();
+
+	// Node of the CPU, or -1 if it is not one of ours
+	[[nodiscard]] int node_of(unsigned cpu) const noexcept;
+
+	// One CPU per worker; CPUs are reused when there are more workers
+	[[nodiscard]] std::vector<unsigned>
+	place(unsigned workers, placement_policy policy) const;
+
+	std::vector<numa_node> nodes{};
+};
+
+// Parses a list such as "0-3,8,10-11", as used by Linux and taskset
+[[nodiscard]] std::vector<unsigned> parse_cpu_list(std::string_view list);
+
+// Restricts a thread to one CPU; throws std::system_error on failure
+void pin_thread(std::thread::native_handle_type thread, unsigned cpu);
+
+// CPU the calling thread runs on, or -1 if unknown
+[[nodiscard]] int current_cpu() noexcept;
+#endif
+#else
+#error This header is for C++20 or later
+#endif
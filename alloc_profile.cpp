@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include "alloc_profile.h"
+
+#ifdef ALLOC_PROFILE
+namespace {
+
+struct counters {
+	std::uint64_t count;
+	std::uint64_t bytes;
+	// Blocks may be freed by another thread than the one allocating them
+	std::int64_t live;
+	std::int64_t peak;
+};
+
+}
+
+static thread_local counters current{0, 0, 0, 0};
+
+/*
+ * Each block is preceded by its size, just before it, in a header padded to
+ * keep the block aligned: to the default alignment, or to a larger one for
+ * the std::align_val_t overloads.
+ */
+static constexpr std::size_t header_size = alignof(std::max_align_t);
+
+static constexpr std::size_t header_offset(const std::size_t align) noexcept
+{
+	return std::max(align, header_size);
+}
+
+static void *allocate(const std::size_t size,
+                      const std::size_t align = header_size) noexcept
+{
+	const std::size_t offset = header_offset(align);
+	if (size > std::numeric_limits<std::size_t>::max() - 2 * offset)
+		[[unlikely]]
+		return nullptr;
+	void *const base = align <= header_size
+		? std::malloc(size + offset)
+		: std::aligned_alloc(align,
+		                     (size + offset + align - 1) / align * align);
+	if (base == nullptr) [[unlikely]]
+		return nullptr;
+	char *const p = static_cast<char *>(base) + offset;
+	*static_cast<std::size_t *>(static_cast<void *>(p - header_size)) = size;
+	++current.count;
+	current.bytes += size;
+	current.live += static_cast<std::int64_t>(size);
+	if (current.live > current.peak)
+		current.peak = current.live;
+	return p;
+}
+
+static void deallocate(void *const p,
+                       const std::size_t align = header_size) noexcept
+{
+	if (p == nullptr)
+		return;
+	char *const c = static_cast<char *>(p);
+	current.live -= static_cast<std::int64_t>(
+		*static_cast<const std::size_t *>(
+			static_cast<void *>(c - header_size)));
+	std::free(c - header_offset(align));
+}
+
+// Calls the new handler until the allocation succeeds, as operator new must
+static void *allocate_or_throw(const std::size_t size,
+                               const std::size_t align = header_size)
+{
+	for (;;) {
+		if (void *const p = allocate(size, align))
+			return p;
+		const std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr) [[unlikely]]
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+static constexpr std::size_t to_size(const std::align_val_t a) noexcept
+{
+	return static_cast<std::size_t>(a);
+}
+
+void reset_alloc_stats() noexcept
+{
+	current = {0, 0, 0, 0};
+}
+
+alloc_stats thread_alloc_stats() noexcept
+{
+	return {current.count, current.bytes,
+	        static_cast<std::uint64_t>(current.peak)};
+}
+
+void *operator new(const std::size_t size)
+{
+	return allocate_or_throw(size);
+}
+
+void *operator new[](const std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return ::operator new(size);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void *const p) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete[](void *const p) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete(void *const p, std::size_t) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete[](void *const p, std::size_t) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete(void *const p, const std::nothrow_t&) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete[](void *const p, const std::nothrow_t&) noexcept
+{
+	deallocate(p);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t a)
+{
+	return allocate_or_throw(size, to_size(a));
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t a)
+{
+	return ::operator new(size, a);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t a,
+                   const std::nothrow_t&) noexcept
+{
+	try {
+		return ::operator new(size, a);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t a,
+                     const std::nothrow_t&) noexcept
+{
+	return ::operator new(size, a, std::nothrow);
+}
+
+void operator delete(void *const p, const std::align_val_t a) noexcept
+{
+	deallocate(p, to_size(a));
+}
+
+void operator delete[](void *const p, const std::align_val_t a) noexcept
+{
+	deallocate(p, to_size(a));
+}
+
+void operator delete(void *const p, std::size_t, const std::align_val_t a)
+	noexcept
+{
+	deallocate(p, to_size(a));
+}
+
+void operator delete[](void *const p, std::size_t, const std::align_val_t a)
+	noexcept
+{
+	deallocate(p, to_size(a));
+}
+
+void operator delete(void *const p, const std::align_val_t a,
+                     const std::nothrow_t&) noexcept
+{
+	deallocate(p, to_size(a));
+}
+
+void operator delete[](void *const p, const std::align_val_t a,
+                       const std::nothrow_t&) noexcept
+{
+	deallocate(p, to_size(a));
+}
+#else
+void reset_alloc_stats() noexcept {}
+
+alloc_stats thread_alloc_stats() noexcept
+{
+	return {0, 0, 0};
+}
+#endif
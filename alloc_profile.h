@@ -0,0 +1,28 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef ALLOC_PROFILE_H
+#define ALLOC_PROFILE_H
+#include <cstdint>
+
+/*
+ * Allocation counters of the calling thread, kept by the replacement global
+ * operator new and delete of builds defining ALLOC_PROFILE. Other builds use
+ * the standard allocator and always report zero.
+ */
+struct alloc_stats {
+	std::uint64_t count;
+	std::uint64_t bytes;
+	std::uint64_t peak;
+};
+
+#ifdef ALLOC_PROFILE
+inline constexpr bool alloc_profiling = true;
+#else
+inline constexpr bool alloc_profiling = false;
+#endif
+
+void reset_alloc_stats() noexcept;
+[[nodiscard]] alloc_stats thread_alloc_stats() noexcept;
+#endif
+#else
+#error This header is for C++20 or later
+#endif
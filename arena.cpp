@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "arena.h"
+
+namespace {
+
+// Blocks released by the arenas of a thread, kept for its next runs
+class block_cache final : public std::pmr::memory_resource {
+public:
+	block_cache() = default;
+	block_cache(const block_cache&) = delete;
+	block_cache& operator=(const block_cache&) = delete;
+
+	~block_cache() override {
+		for (const block& b : blocks)
+			free(b);
+	}
+
+private:
+	struct block {
+		void *p;
+		std::size_t size;
+		std::size_t align;
+	};
+
+	static void free(const block& b) noexcept {
+		::operator delete(b.p, b.size, std::align_val_t{b.align});
+	}
+
+	// Arenas ask for the same growing sizes on every run
+	void *do_allocate(const std::size_t size, const std::size_t align)
+		override
+	{
+		for (block& b : blocks) {
+			if (b.size == size && b.align == align) {
+				void *const p = b.p;
+				b = blocks.back();
+				blocks.pop_back();
+				return p;
+			}
+		}
+		return ::operator new(size, std::align_val_t{align});
+	}
+
+	void do_deallocate(void *const p, const std::size_t size,
+	                   const std::size_t align) override
+	{
+		try {
+			blocks.push_back({p, size, align});
+		} catch (const std::bad_alloc&) {
+			free({p, size, align});
+		}
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other)
+		const noexcept override
+	{
+		return this == &other;
+	}
+
+	std::vector<block> blocks{};
+};
+
+constexpr std::size_t initial_block = 64 * 1024;
+
+thread_local block_cache cache;
+thread_local std::pmr::memory_resource *current = nullptr;
+
+}
+
+arena_scope::arena_scope()
+	: arena{initial_block, &cache}
+	, previous{current}
+{
+	current = &arena;
+}
+
+arena_scope::~arena_scope()
+{
+	current = previous;
+}
+
+std::pmr::memory_resource *day_arena() noexcept
+{
+	return current ? current : std::pmr::get_default_resource();
+}
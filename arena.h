@@ -0,0 +1,33 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef ARENA_H
+#define ARENA_H
+#include <memory_resource>
+
+/*
+ * Monotonic arena for the node-based containers of one run of a day, in
+ * place while the scope lives. Nodes are allocated by bumping a pointer and
+ * never freed one by one; the whole arena goes away with the scope. Its
+ * blocks come from a cache of the calling thread, so that later runs on the
+ * same thread reuse them rather than ask the system again.
+ *
+ * Scopes nest, and an arena is not thread-safe: containers using it must stay
+ * on the thread running the day and must not outlive the scope.
+ */
+class arena_scope {
+public:
+	arena_scope();
+	arena_scope(const arena_scope&) = delete;
+	arena_scope& operator=(const arena_scope&) = delete;
+	~arena_scope();
+
+private:
+	std::pmr::monotonic_buffer_resource arena;
+	std::pmr::memory_resource *previous;
+};
+
+// Arena of the innermost scope of the thread, or the default resource
+[[nodiscard]] std::pmr::memory_resource *day_arena() noexcept;
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "baseline.h"
+#include "counters.h"
+
+// Standard errors of the difference beyond which a change is not noise
+static constexpr double significance = 3;
+
+static std::optional<std::uint64_t> read_optional(std::istream& in)
+{
+	if (in >> std::ws && in.peek() == '-') {
+		in.ignore();
+		return std::nullopt;
+	}
+	std::uint64_t x;
+	if (!(in >> x)) [[unlikely]]
+		throw std::runtime_error("Bad counter in benchmark results");
+	return x;
+}
+
+void benchmark_store::read(std::istream& in)
+{
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line.front() == '#')
+			continue;
+		std::istringstream s{line};
+		std::size_t day;
+		day_record r{};
+		if (!(s >> day >> r.runs) || day < 1 || day > records.size()
+		    || r.runs == 0) [[unlikely]]
+			throw std::runtime_error("Bad day in benchmark results");
+		for (stage_record& t : r.stages) {
+			std::chrono::nanoseconds::rep median;
+			double stddev;
+			if (!(s >> median >> stddev)) [[unlikely]]
+				throw std::runtime_error(
+					"Bad time in benchmark results");
+			t = {std::chrono::nanoseconds{median},
+			     std::chrono::duration<double, std::nano>{stddev}};
+		}
+		if (!(s >> r.allocs.count >> r.allocs.bytes >> r.allocs.peak))
+			[[unlikely]]
+			throw std::runtime_error(
+				"Bad allocations in benchmark results");
+		for (auto& c : r.counters.values)
+			c = read_optional(s);
+		records[day - 1] = r;
+	}
+	if (!in.eof()) [[unlikely]]
+		throw std::runtime_error("Error while reading benchmark results");
+}
+
+void benchmark_store::write(std::ostream& out) const
+{
+	out << "# day runs parse sd part1 sd part2 sd total sd allocs bytes"
+	       " peak cycles instructions l1d-misses llc-misses"
+	       " branch-misses\n";
+	for (std::size_t d = 0; d < records.size(); ++d) {
+		if (!records[d])
+			continue;
+		const day_record& r = *records[d];
+		out << (d + 1) << ' ' << r.runs;
+		for (const stage_record& t : r.stages)
+			out << ' ' << t.median.count() << ' '
+			    << std::llround(t.stddev.count());
+		out << ' ' << r.allocs.count << ' ' << r.allocs.bytes << ' '
+		    << r.allocs.peak;
+		for (const auto& c : r.counters.values) {
+			if (c)
+				out << ' ' << *c;
+			else
+				out << " -";
+		}
+		out << '\n';
+	}
+}
+
+/*
+ * The standard error of a median is about sqrt(pi / 2) times that of the
+ * mean of as many samples.
+ */
+static double median_error(const stage_record& t, const unsigned runs)
+{
+	constexpr double ratio = 1.2533;
+	return ratio * t.stddev.count() / std::sqrt(static_cast<double>(runs));
+}
+
+stage_delta
+compare_stage(const stage_record& base, const unsigned base_runs,
+              const stage_record& now, const unsigned now_runs,
+              const double threshold)
+{
+	const auto b = static_cast<double>(base.median.count());
+	const double diff = static_cast<double>(now.median.count()) - b;
+	const double change = b > 0 ? diff / b : 0;
+	const double eb = median_error(base, base_runs);
+	const double en = median_error(now, now_runs);
+	const double noise = significance * std::sqrt(eb * eb + en * en);
+	if (std::abs(diff) <= noise || std::abs(change) <= threshold)
+		return {change, verdict::same};
+	return {change, diff > 0 ? verdict::slower : verdict::faster};
+}
@@ -0,0 +1,82 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef BASELINE_H
+#define BASELINE_H
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "alloc_profile.h"
+#include "counters.h"
+
+// Parse, part 1, part 2 and their total
+inline constexpr std::size_t num_stages = 4;
+
+inline constexpr std::string_view stage_names[num_stages] = {
+	"parse", "part 1", "part 2", "total"
+};
+
+struct stage_record {
+	std::chrono::nanoseconds median;
+	std::chrono::duration<double, std::nano> stddev;
+};
+
+// Benchmark of one day: times per stage, allocations and counters per run
+struct day_record {
+	unsigned runs;
+	std::array<stage_record, num_stages> stages;
+	alloc_stats allocs;
+	counter_values counters;
+};
+
+/*
+ * Benchmark results of every day, persisted as one line per day: the day, the
+ * number of runs, the median and standard deviation of each stage in
+ * nanoseconds, allocations, bytes and peak bytes, then the hardware counters,
+ * with a dash for every missing counter. Lines starting with # are comments.
+ */
+class benchmark_store {
+public:
+	explicit benchmark_store(const std::size_t num_days)
+		: records(num_days)
+	{}
+
+	void read(std::istream& in);
+	void write(std::ostream& out) const;
+
+	void set(const std::size_t day, const day_record& r) {
+		records.at(day) = r;
+	}
+
+	[[nodiscard]] const std::optional<day_record>&
+	get(const std::size_t day) const {
+		return records.at(day);
+	}
+
+private:
+	std::vector<std::optional<day_record>> records;
+};
+
+enum class verdict { same, faster, slower };
+
+struct stage_delta {
+	// Relative change of the median, positive when slower
+	double change;
+	verdict v;
+};
+
+/*
+ * A change counts only when it is larger than threshold (relative to the
+ * base median) and than the noise of both measurements.
+ */
+[[nodiscard]] stage_delta
+compare_stage(const stage_record& base, unsigned base_runs,
+              const stage_record& now, unsigned now_runs, double threshold);
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.h"
+
+// Nearest-rank percentile of sorted samples
+static std::chrono::nanoseconds
+percentile(const std::vector<std::chrono::nanoseconds>& sorted,
+           const unsigned p)
+{
+	const std::size_t n = sorted.size();
+	std::size_t rank = (p * n + 99) / 100;
+	if (rank > 0)
+		--rank;
+	return sorted[rank];
+}
+
+sample_summary summarize(std::vector<std::chrono::nanoseconds> samples)
+{
+	using fp_ns = std::chrono::duration<double, std::nano>;
+	if (samples.empty()) [[unlikely]]
+		throw std::invalid_argument("No sample to summarize");
+	std::sort(samples.begin(), samples.end());
+	fp_ns sum{0};
+	for (const auto s : samples)
+		sum += s;
+	const fp_ns mean = sum / static_cast<double>(samples.size());
+	double square_sum = 0;
+	for (const auto s : samples) {
+		const double d = (fp_ns{s} - mean).count();
+		square_sum += d * d;
+	}
+	const double variance = samples.size() > 1
+		? square_sum / static_cast<double>(samples.size() - 1)
+		: 0;
+	return {samples.front(), percentile(samples, 50),
+	        percentile(samples, 90), percentile(samples, 99),
+	        samples.back(), mean, fp_ns{std::sqrt(variance)}};
+}
+
+static long long count(const std::chrono::nanoseconds d)
+{
+	return d.count();
+}
+
+static long long count(const std::chrono::duration<double, std::nano> d)
+{
+	return std::llround(d.count());
+}
+
+// One column per summary, one row per statistic, all in nanoseconds
+std::ostream&
+print_summaries(std::ostream& out, std::span<const std::string_view> names,
+                std::span<const sample_summary> summaries)
+{
+	if (names.size() != summaries.size()) [[unlikely]]
+		throw std::invalid_argument("Need one name per summary");
+	for (const std::string_view name : names)
+		out << '\t' << name;
+	out << '\n';
+	const auto row = [&](const char *label, auto field) {
+		out << label;
+		for (const sample_summary& s : summaries)
+			out << '\t' << count(s.*field);
+		out << '\n';
+	};
+	row("min", &sample_summary::min);
+	row("median", &sample_summary::median);
+	row("p90", &sample_summary::p90);
+	row("p99", &sample_summary::p99);
+	row("max", &sample_summary::max);
+	row("mean", &sample_summary::mean);
+	row("stddev", &sample_summary::stddev);
+	return out;
+}
+
+// Slope of the regression line of log(time) on log(size)
+double fit_exponent(std::span<const double> sizes,
+                    std::span<const double> times)
+{
+	if (sizes.size() != times.size() || sizes.size() < 2) [[unlikely]]
+		throw std::invalid_argument("Need two points per fit at least");
+	const auto n = static_cast<double>(sizes.size());
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+	for (std::size_t i = 0; i < sizes.size(); ++i) {
+		const double x = std::log(sizes[i]);
+		const double y = std::log(times[i]);
+		sx += x;
+		sy += y;
+		sxx += x * x;
+		sxy += x * y;
+	}
+	const double d = n * sxx - sx * sx;
+	if (d == 0) [[unlikely]]
+		throw std::invalid_argument("Sizes must not all be equal");
+	return (n * sxy - sx * sy) / d;
+}
@@ -0,0 +1,33 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <chrono>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+struct sample_summary {
+	std::chrono::nanoseconds min;
+	std::chrono::nanoseconds median;
+	std::chrono::nanoseconds p90;
+	std::chrono::nanoseconds p99;
+	std::chrono::nanoseconds max;
+	std::chrono::duration<double, std::nano> mean;
+	std::chrono::duration<double, std::nano> stddev;
+};
+
+[[nodiscard]] sample_summary
+summarize(std::vector<std::chrono::nanoseconds> samples);
+
+std::ostream&
+print_summaries(std::ostream& out, std::span<const std::string_view> names,
+                std::span<const sample_summary> summaries);
+
+// Exponent k of the best fit of times to c * sizes^k, by least squares
+[[nodiscard]] double fit_exponent(std::span<const double> sizes,
+                                  std::span<const double> times);
+#endif
+#else
+#error This header is for C++20 or later
+#endif
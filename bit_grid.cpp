@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "bit_grid.h"
+
+namespace {
+
+constexpr std::size_t word_bits = std::numeric_limits<bit_grid::word>::digits;
+
+constexpr bit_grid::word bit(const std::size_t x) noexcept
+{
+	return bit_grid::word{1} << (x % word_bits);
+}
+
+}
+
+bit_grid::bit_grid(const size_type width, const size_type height)
+	: w{width}
+	, h{height}
+	, words{(width + word_bits - 1) / word_bits}
+	, last{width % word_bits == 0 ? ~word{0} : bit(width) - 1}
+	, bits(words * height, 0)
+{}
+
+bool bit_grid::test(const size_type x, const size_type y) const noexcept
+{
+	return (row(y)[x / word_bits] & bit(x)) != 0;
+}
+
+void bit_grid::set(const size_type x, const size_type y) noexcept
+{
+	row(y)[x / word_bits] |= bit(x);
+}
+
+void bit_grid::clear() noexcept
+{
+	std::fill(bits.begin(), bits.end(), 0);
+}
+
+void bit_grid::flip() noexcept
+{
+	for (word& b : bits)
+		b = ~b;
+	if (words == 0)
+		return;
+	for (size_type y = 0; y < h; ++y)
+		row(y)[words - 1] &= last;
+}
+
+bool bit_grid::any() const noexcept
+{
+	return std::any_of(bits.cbegin(), bits.cend(),
+	                   [](const word b) { return b != 0; });
+}
+
+bit_grid::size_type bit_grid::count() const noexcept
+{
+	size_type n = 0;
+	for (const word b : bits)
+		n += static_cast<size_type>(std::popcount(b));
+	return n;
+}
+
+bool bit_grid::intersects(const bit_grid& other) const noexcept
+{
+	for (size_type i = 0; i < bits.size(); ++i) {
+		if ((bits[i] & other.bits[i]) != 0)
+			return true;
+	}
+	return false;
+}
+
+bit_grid::size_type bit_grid::count_common(const bit_grid& other)
+	const noexcept
+{
+	size_type n = 0;
+	for (size_type i = 0; i < bits.size(); ++i)
+		n += static_cast<size_type>(std::popcount(bits[i] & other.bits[i]));
+	return n;
+}
+
+bit_grid& bit_grid::operator|=(const bit_grid& other) noexcept
+{
+	for (size_type i = 0; i < bits.size(); ++i)
+		bits[i] |= other.bits[i];
+	return *this;
+}
+
+bit_grid& bit_grid::operator&=(const bit_grid& other) noexcept
+{
+	for (size_type i = 0; i < bits.size(); ++i)
+		bits[i] &= other.bits[i];
+	return *this;
+}
+
+void bit_grid::and_not(const bit_grid& other) noexcept
+{
+	for (size_type i = 0; i < bits.size(); ++i)
+		bits[i] &= ~other.bits[i];
+}
+
+bit_grid::word bit_grid::from_left(const word *const r, const size_type k)
+	const noexcept
+{
+	const word carry = k > 0 ? r[k - 1] >> (word_bits - 1) : 0;
+	return r[k] << 1 | carry;
+}
+
+bit_grid::word bit_grid::from_right(const word *const r, const size_type k)
+	const noexcept
+{
+	const word carry = k + 1 < words ? r[k + 1] << (word_bits - 1) : 0;
+	return r[k] >> 1 | carry;
+}
+
+void bit_grid::spread(const bit_grid& from) noexcept
+{
+	for (size_type y = 0; y < h; ++y) {
+		const word *const r = from.row(y);
+		const word *const up = y > 0 ? from.row(y - 1) : nullptr;
+		const word *const down = y + 1 < h ? from.row(y + 1) : nullptr;
+		word *const to = row(y);
+		for (size_type k = 0; k < words; ++k) {
+			word b = r[k] | from_left(r, k) | from_right(r, k);
+			if (up)
+				b |= up[k];
+			if (down)
+				b |= down[k];
+			to[k] = b;
+		}
+		if (words != 0)
+			to[words - 1] &= last;
+	}
+}
+
+/*
+ * Shifted rows may carry a bit past the width, but this set has none there,
+ * so it does not count.
+ */
+bit_grid::size_type bit_grid::count_touching(const bit_grid& other)
+	const noexcept
+{
+	size_type n = 0;
+	const auto pairs = [&n](const word a, const word b) {
+		n += static_cast<size_type>(std::popcount(a & b));
+	};
+	for (size_type y = 0; y < h; ++y) {
+		const word *const a = row(y);
+		const word *const b = other.row(y);
+		for (size_type k = 0; k < words; ++k) {
+			pairs(a[k], other.from_left(b, k));
+			pairs(a[k], other.from_right(b, k));
+			if (y > 0)
+				pairs(a[k], other.row(y - 1)[k]);
+			if (y + 1 < h)
+				pairs(a[k], other.row(y + 1)[k]);
+		}
+	}
+	return n;
+}
+
+void bit_grid::rotate_up() noexcept
+{
+	if (h != 0)
+		std::rotate(bits.begin(), bits.begin() + static_cast<
+			std::vector<word>::difference_type>(words), bits.end());
+}
+
+void bit_grid::rotate_down() noexcept
+{
+	if (h != 0)
+		std::rotate(bits.begin(), bits.end() - static_cast<
+			std::vector<word>::difference_type>(words), bits.end());
+}
+
+void bit_grid::rotate_left() noexcept
+{
+	if (w == 0)
+		return;
+	for (size_type y = 0; y < h; ++y) {
+		word *const r = row(y);
+		const bool wraps = (r[0] & 1) != 0;
+		for (size_type k = 0; k < words; ++k)
+			r[k] = from_right(r, k);
+		if (wraps)
+			r[(w - 1) / word_bits] |= bit(w - 1);
+	}
+}
+
+void bit_grid::rotate_right() noexcept
+{
+	if (w == 0)
+		return;
+	for (size_type y = 0; y < h; ++y) {
+		word *const r = row(y);
+		const bool wraps = (r[(w - 1) / word_bits] & bit(w - 1)) != 0;
+		for (size_type k = words; k-- > 0;)
+			r[k] = from_left(r, k);
+		r[words - 1] &= last;
+		if (wraps)
+			r[0] |= 1;
+	}
+}
+
+bit_volume::bit_volume(const size_type width, const size_type height,
+                       const size_type depth)
+	: layers(depth, bit_grid{width, height})
+{}
+
+void bit_volume::clear() noexcept
+{
+	for (bit_grid& l : layers)
+		l.clear();
+}
+
+void bit_volume::flip() noexcept
+{
+	for (bit_grid& l : layers)
+		l.flip();
+}
+
+bool bit_volume::any() const noexcept
+{
+	return std::any_of(layers.cbegin(), layers.cend(),
+	                   [](const bit_grid& l) { return l.any(); });
+}
+
+bit_volume::size_type bit_volume::count() const noexcept
+{
+	size_type n = 0;
+	for (const bit_grid& l : layers)
+		n += l.count();
+	return n;
+}
+
+bit_volume& bit_volume::operator|=(const bit_volume& other) noexcept
+{
+	for (size_type z = 0; z < layers.size(); ++z)
+		layers[z] |= other.layers[z];
+	return *this;
+}
+
+bit_volume& bit_volume::operator&=(const bit_volume& other) noexcept
+{
+	for (size_type z = 0; z < layers.size(); ++z)
+		layers[z] &= other.layers[z];
+	return *this;
+}
+
+void bit_volume::and_not(const bit_volume& other) noexcept
+{
+	for (size_type z = 0; z < layers.size(); ++z)
+		layers[z].and_not(other.layers[z]);
+}
+
+void bit_volume::spread(const bit_volume& from) noexcept
+{
+	for (size_type z = 0; z < layers.size(); ++z) {
+		layers[z].spread(from.layers[z]);
+		if (z > 0)
+			layers[z] |= from.layers[z - 1];
+		if (z + 1 < layers.size())
+			layers[z] |= from.layers[z + 1];
+	}
+}
+
+bit_volume::size_type bit_volume::count_touching(const bit_volume& other)
+	const noexcept
+{
+	size_type n = 0;
+	for (size_type z = 0; z < layers.size(); ++z) {
+		n += layers[z].count_touching(other.layers[z]);
+		if (z > 0)
+			n += layers[z].count_common(other.layers[z - 1]);
+		if (z + 1 < layers.size())
+			n += layers[z].count_common(other.layers[z + 1]);
+	}
+	return n;
+}
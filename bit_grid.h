@@ -0,0 +1,166 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+ * Set of the cells of a width by height rectangle, stored as rows of bits,
+ * bit x of a row in word x / 64. Bits past the width are kept clear. Every
+ * operation goes a word at a time, so that a breadth-first search moves its
+ * whole frontier by one step with a few shifts, ORs and ANDs per word.
+ *
+ * Sets combined by an operation must have the same size.
+ */
+class bit_grid {
+public:
+	using word = std::uint64_t;
+	using size_type = std::size_t;
+
+	bit_grid() = default;
+	bit_grid(size_type width, size_type height);
+
+	[[nodiscard]] size_type width() const noexcept { return w; }
+	[[nodiscard]] size_type height() const noexcept { return h; }
+
+	[[nodiscard]] bool test(size_type x, size_type y) const noexcept;
+	void set(size_type x, size_type y) noexcept;
+
+	void clear() noexcept;
+	// Complement within the rectangle
+	void flip() noexcept;
+	[[nodiscard]] bool any() const noexcept;
+	[[nodiscard]] size_type count() const noexcept;
+	[[nodiscard]] bool intersects(const bit_grid& other) const noexcept;
+	[[nodiscard]] size_type count_common(const bit_grid& other)
+		const noexcept;
+
+	bit_grid& operator|=(const bit_grid& other) noexcept;
+	bit_grid& operator&=(const bit_grid& other) noexcept;
+	// Removes the cells of other
+	void and_not(const bit_grid& other) noexcept;
+
+	// Cells of from and their neighbors up, down, left and right
+	void spread(const bit_grid& from) noexcept;
+
+	// Pairs of a cell of this set and a neighbor of it in other
+	[[nodiscard]] size_type count_touching(const bit_grid& other)
+		const noexcept;
+
+	// Each cell moves by one, those leaving an edge coming back opposite
+	void rotate_up() noexcept;
+	void rotate_down() noexcept;
+	void rotate_left() noexcept;
+	void rotate_right() noexcept;
+
+private:
+	[[nodiscard]] word *row(size_type y) noexcept {
+		return bits.data() + y * words;
+	}
+
+	[[nodiscard]] const word *row(size_type y) const noexcept {
+		return bits.data() + y * words;
+	}
+
+	// Word k of a row shifted so that each cell gets its left neighbor
+	[[nodiscard]] word from_left(const word *r, size_type k)
+		const noexcept;
+	// Likewise with the right neighbor
+	[[nodiscard]] word from_right(const word *r, size_type k)
+		const noexcept;
+
+	size_type w = 0;
+	size_type h = 0;
+	size_type words = 0;
+	// Bits of the last word of a row which are inside
+	word last = 0;
+	std::vector<word> bits{};
+};
+
+/*
+ * Set of the cells of a box, as one bit_grid per layer; neighbors are also
+ * found in the layers above and below.
+ */
+class bit_volume {
+public:
+	using size_type = bit_grid::size_type;
+
+	bit_volume() = default;
+	bit_volume(size_type width, size_type height, size_type depth);
+
+	[[nodiscard]] bool test(size_type x, size_type y, size_type z)
+		const noexcept
+	{
+		return layers[z].test(x, y);
+	}
+
+	void set(size_type x, size_type y, size_type z) noexcept {
+		layers[z].set(x, y);
+	}
+
+	void clear() noexcept;
+	void flip() noexcept;
+	[[nodiscard]] bool any() const noexcept;
+	[[nodiscard]] size_type count() const noexcept;
+
+	bit_volume& operator|=(const bit_volume& other) noexcept;
+	bit_volume& operator&=(const bit_volume& other) noexcept;
+	void and_not(const bit_volume& other) noexcept;
+
+	void spread(const bit_volume& from) noexcept;
+
+	[[nodiscard]] size_type count_touching(const bit_volume& other)
+		const noexcept;
+
+private:
+	std::vector<bit_grid> layers{};
+};
+
+/*
+ * Breadth-first search over a bit_grid or a bit_volume, a level at a time:
+ * the next frontier is made of the cells reached from the current one which
+ * were not visited before.
+ */
+template<class Set>
+class bit_search {
+public:
+	explicit bit_search(const Set& start)
+		: current{start}
+		, seen{start}
+		, next{start}
+	{}
+
+	[[nodiscard]] const Set& frontier() const noexcept { return current; }
+	[[nodiscard]] const Set& visited() const noexcept { return seen; }
+
+	// Moves to the passable neighbors; false once none are left
+	bool step(const Set& passable) {
+		return expand([&passable](Set& n, const Set& f) {
+			n.spread(f);
+			n &= passable;
+		});
+	}
+
+	// Moves to the cells reach(n, frontier) puts in n
+	template<class F>
+		requires std::invocable<F&, Set&, const Set&>
+	bool expand(F reach) {
+		reach(next, std::as_const(current));
+		next.and_not(seen);
+		seen |= next;
+		std::swap(current, next);
+		return current.any();
+	}
+
+private:
+	Set current;
+	Set seen;
+	Set next;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
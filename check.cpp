@@ -0,0 +1,259 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "arena.h"
+#include "baseline.h"
+#include "common.h"
+#include "exec_context.h"
+#include "flat_hash.h"
+#include "registry.h"
+#include "result_cache.h"
+#include "thread_pool.h"
+
+/*
+ * Checks of what can be tested on its own, run by make check. Each failed
+ * check is reported and makes the program exit with a failure.
+ */
+
+namespace {
+
+int failures = 0;
+
+void check(const bool ok, const std::string_view what)
+{
+	if (ok)
+		return;
+	std::cerr << "FAILED: " << what << std::endl;
+	++failures;
+}
+
+std::string to_text(const puzzle_output& o)
+{
+	std::ostringstream s;
+	s << o;
+	return s.str();
+}
+
+// Answers of day d to an input, running its stages as the runners do
+void check_day(const std::size_t d, const std::string_view input,
+               const std::string_view part1, const std::string_view part2)
+{
+	const arena_scope arena;
+	const std::unique_ptr<parsed_input> p = days[d - 1].parse(input);
+	const std::string first = to_text(p->part1());
+	const std::string second = to_text(p->part2());
+	const std::string name = "day " + std::to_string(d);
+	check(first == part1, name + " part 1 gave " + first);
+	check(second == part2, name + " part 2 gave " + second);
+}
+
+void check_days()
+{
+	// The baseline gave 12 for part 2, fewer than the marker's length
+	check_day(6, "mjqjpqmgbljsphdztnvjfqwrcgsmlb\n", "7", "19");
+	// The baseline found no path in this example
+	check_day(12, "Sabqponm\nabcryxxl\naccszExk\nacctuvwj\nabdefghi\n",
+	          "31", "29");
+	// The first unit of sand falls to the floor: none comes to rest above
+	check_day(14, "498,4 -> 498,6 -> 496,6\n", "0", "58");
+	// Sand piles up to the source before any reaches the floor
+	check_day(14, "498,2 -> 502,2\n", "4", "4");
+}
+
+// Spins until flag is set, giving up after a while
+bool wait_for(const std::atomic<bool>& flag)
+{
+	using namespace std::literals;
+	const auto deadline = std::chrono::steady_clock::now() + 2s;
+	while (!flag.load()) {
+		if (std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+/*
+ * Worker 0 is planned a parallel day a, then a day b. Worker 1 is held until
+ * a has queued its helper, and must then help a before it may steal b.
+ */
+void check_plan_order()
+{
+	std::atomic<bool> helper_queued = false;
+	std::atomic<bool> helped = false;
+	std::atomic<bool> b_early = false;
+	{
+		thread_pool pool{2};
+		const exec_context ctx{pool};
+		std::vector<std::vector<thread_pool::task_type>> plan(2);
+		plan[0].emplace_back([&] {
+			exec_context c = ctx;
+			const auto caller = std::this_thread::get_id();
+			c.parallel_for(0, 2, [&](const std::size_t) {
+				if (std::this_thread::get_id() != caller) {
+					helped = true;
+				} else if (!helper_queued.exchange(true)) {
+					// Someone else must take the other chunk
+					wait_for(helped);
+				}
+			});
+		});
+		plan[0].emplace_back([&] { b_early = !helped.load(); });
+		plan[1].emplace_back([&] { wait_for(helper_queued); });
+		pool.submit_plan(std::move(plan));
+	}
+	check(helped.load(), "idle worker helped the running day");
+	check(!b_early.load(), "planned day did not start before helpers");
+}
+
+// Verdict on a stage whose median went from base to now nanoseconds
+verdict judge(const long base, const long now, const double stddev,
+              const unsigned runs)
+{
+	using ns = std::chrono::nanoseconds;
+	const stage_record b{ns{base}, std::chrono::duration<double, std::nano>{
+		stddev}};
+	const stage_record n{ns{now}, b.stddev};
+	return compare_stage(b, runs, n, runs, 0.05).v;
+}
+
+void check_compare_stage()
+{
+	check(judge(1000, 1500, 0, 10) == verdict::slower,
+	      "steady slowdown is slower");
+	check(judge(1000, 500, 0, 10) == verdict::faster,
+	      "steady speedup is faster");
+	check(judge(1000, 1020, 0, 10) == verdict::same,
+	      "change under the threshold is the same");
+	check(judge(1000, 1500, 500, 4) == verdict::same,
+	      "change within the noise is the same");
+	check(judge(1000, 1500, 500, 400) == verdict::slower,
+	      "change beyond the noise of many runs is slower");
+	check(judge(0, 100, 0, 10) == verdict::same,
+	      "stage which took no time is the same");
+	const stage_record b{std::chrono::nanoseconds{200}, {}};
+	const stage_record n{std::chrono::nanoseconds{300}, {}};
+	check(compare_stage(b, 10, n, 10, 0).change == 0.5,
+	      "change is relative to the base median");
+}
+
+// Keys in fours share a home slot, so that most elements are displaced
+struct clustered_hash {
+	std::uint64_t operator()(const int k) const noexcept {
+		return static_cast<std::uint64_t>(k / 4);
+	}
+};
+
+/*
+ * Random inserts, then mostly erases, each compared with a std::set: the
+ * table grows through several rehashes and erases elements pushed away from
+ * their home slots.
+ */
+void check_flat_hash_set()
+{
+	flat_hash_set<int, clustered_hash> set{std::pmr::get_default_resource()};
+	std::set<int> expected;
+	std::uint64_t seed = 1;
+	bool same = true;
+	constexpr int steps = 20000;
+	for (int n = 0; n < steps; ++n) {
+		seed = seed * 6364136223846793005 + 1442695040888963407;
+		const int k = static_cast<int>(seed >> 55);
+		const bool adding = (seed >> 40 & 3) != 0;
+		if (adding == (n < steps / 2))
+			same &= set.insert(k).second == expected.insert(k).second;
+		else
+			same &= set.erase(k) == expected.erase(k);
+		same &= set.size() == expected.size();
+	}
+	for (int k = 0; k < 512; ++k)
+		same &= set.contains(k) == expected.contains(k);
+	check(same, "flat_hash_set matches std::set through erases");
+	const std::set<int> listed(set.begin(), set.end());
+	check(listed == expected, "flat_hash_set lists its elements");
+}
+
+// Values stay with their keys while the table is rehashed many times
+void check_flat_hash_map()
+{
+	struct cell {
+		int x;
+		int y;
+		bool operator==(const cell&) const = default;
+	};
+	flat_hash_map<cell, int> map;
+	for (int y = -50; y < 50; ++y) {
+		for (int x = -50; x < 50; ++x)
+			map[{x, y}] = x * 100 + y;
+	}
+	bool found = map.size() == 10000;
+	for (int y = -50; y < 50; ++y) {
+		for (int x = -50; x < 50; ++x) {
+			const auto it = map.find({x, y});
+			found &= it != map.end() && it->second == x * 100 + y;
+		}
+	}
+	found &= map.find({50, 0}) == map.end();
+	check(found, "flat_hash_map keeps values through rehashes");
+}
+
+// Answers stored are found again, and a damaged entry is only a miss
+void check_result_cache()
+{
+	namespace fs = std::filesystem;
+	const fs::path dir = fs::temp_directory_path()
+	                     / ("advent-check-" + std::to_string(::getpid()));
+	{
+		const result_cache cache{dir};
+		const result_cache::answers a{"24", "93\nover two lines"};
+		check(!cache.find(13, "input"), "cache misses before storing");
+		check(cache.store(13, "input", a), "cache stores answers");
+		check(cache.find(13, "input") == a, "cache finds stored answers");
+		check(!cache.find(13, "other"), "cache misses another input");
+		const fs::path entry = fs::directory_iterator{dir}->path();
+		for (const char *bad : {"", "2\n24", "-1\n24", "99999999999\n24",
+		                        "99999999999999999999\n", "3\n24",
+		                        "2\n242\n93x"}) {
+			std::ofstream{entry, std::ios::binary} << bad;
+			check(!cache.find(13, "input"),
+			      "damaged cache entry misses: " + std::string(bad));
+		}
+		check(cache.store(13, "input", a), "cache replaces damaged entry");
+		check(cache.find(13, "input") == a, "cache finds replaced entry");
+	}
+	fs::remove_all(dir);
+}
+
+}
+
+int main()
+{
+	check_days();
+	check_plan_order();
+	check_compare_stage();
+	check_flat_hash_set();
+	check_flat_hash_map();
+	check_result_cache();
+	if (failures != 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "All checks passed" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -1,8 +1,14 @@
 #include <ostream>
 
 #include "common.h"
+#include "exec_context.h"
 
 std::ostream& operator<<(std::ostream& out, const puzzle_output& x)
 {
 	return x.is_string ? out << x.u.s : out << x.u.i;
 }
+
+exec_context& parsed_input::context() const noexcept
+{
+	return ctx ? *ctx : exec_context::serial();
+}
@@ -1,8 +1,15 @@
 #if defined __cplusplus && __cplusplus >= 202002L
+#ifndef COMMON_H
+#define COMMON_H
 #include <cstdint>
 #include <istream>
+#include <memory>
 #include <ostream>
+#include <streambuf>
 #include <string>
+#include <string_view>
+
+#include "arena.h"
 
 class puzzle_output {
 	friend std::ostream& operator<<(std::ostream&, const puzzle_output&);
@@ -63,7 +70,75 @@ struct output_pair {
 	puzzle_output second;
 };
 
-template<int D> output_pair day(std::istream& in);
+class exec_context;
+
+/*
+ * Puzzle input once parsed. The runner calls part1() then part2(), each at
+ * most once and in that order, so a day may carry state from one part to the
+ * next. The input text outlives it, so it may keep views into that text.
+ */
+class parsed_input {
+public:
+	parsed_input() = default;
+	parsed_input(const parsed_input&) = delete;
+	parsed_input& operator=(const parsed_input&) = delete;
+	virtual ~parsed_input() = default;
+	virtual puzzle_output part1() = 0;
+	virtual puzzle_output part2() = 0;
+
+	// Set by the runner before the parts to share its threads with them
+	void set_context(exec_context& c) noexcept { ctx = &c; }
+
+protected:
+	// Where parts may run parallel work, serially unless the runner says
+	[[nodiscard]] exec_context& context() const noexcept;
+
+private:
+	exec_context *ctx = nullptr;
+};
+
+// Stream buffer reading characters owned by something else
+class view_streambuf final : public std::streambuf {
+public:
+	explicit view_streambuf(const std::string_view s) noexcept {
+		// The get area is never written to
+		char *const p = const_cast<char *>(s.data());
+		setg(p, p, p + s.size());
+	}
+};
+
+// Removes the first line of the input and returns it without its newline
+constexpr std::string_view next_line(std::string_view& in) noexcept
+{
+	const std::size_t end = in.find('\n');
+	const std::string_view line = in.substr(0, end);
+	in.remove_prefix(end == in.npos ? in.size() : end + 1);
+	return line;
+}
+
+template<int D> std::unique_ptr<parsed_input> parse(std::istream& in);
+
+/*
+ * Entry point used by the runner, with the whole input in memory. Days which
+ * parse it in place specialize this; the others are read through a stream.
+ */
+template<int D> std::unique_ptr<parsed_input> parse(const std::string_view in)
+{
+	view_streambuf buf{in};
+	std::istream s{&buf};
+	return parse<D>(s);
+}
+
+template<int D>
+output_pair day(const std::string_view in, exec_context& ctx)
+{
+	const arena_scope arena;
+	const std::unique_ptr<parsed_input> p = parse<D>(in);
+	p->set_context(ctx);
+	puzzle_output first = p->part1();
+	return {static_cast<puzzle_output&&>(first), p->part2()};
+}
+#endif
 #else
 #error This header is for C++20 or later
 #endif
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "cost_model.h"
+
+// Weight of a new measurement in the moving average
+static constexpr long ema_weight = 4;
+
+cost_model::cost_model(std::span<const duration> initial)
+	: costs(initial.begin(), initial.end())
+{}
+
+void cost_model::read(std::istream& in)
+{
+	std::size_t day;
+	duration::rep ns;
+	while (in >> day >> ns) {
+		if (day < 1 || day > costs.size() || ns < 0) [[unlikely]]
+			throw std::runtime_error("Bad entry in cost database");
+		costs[day - 1] = duration{ns};
+	}
+	if (!in.eof()) [[unlikely]]
+		throw std::runtime_error("Error while reading cost database");
+}
+
+void cost_model::write(std::ostream& out) const
+{
+	for (std::size_t d = 0; d < costs.size(); ++d)
+		out << (d + 1) << ' ' << costs[d].count() << '\n';
+}
+
+void cost_model::update(const std::size_t day, const duration measured)
+{
+	duration& c = costs.at(day);
+	c += (measured - c) / ema_weight;
+}
+
+/*
+ * Longest-processing-time-first: days are taken from the most to the least
+ * expensive and each goes to the worker with the least work so far. Every
+ * worker's list is sorted by decreasing cost.
+ */
+std::vector<std::vector<std::size_t>>
+cost_model::schedule(const unsigned num_workers) const
+{
+	if (num_workers == 0) [[unlikely]]
+		throw std::invalid_argument("Cannot schedule on no worker");
+	std::vector<std::size_t> order(costs.size());
+	std::iota(order.begin(), order.end(), std::size_t{0});
+	const auto by_cost = [this](std::size_t a, std::size_t b) {
+		return costs[a] > costs[b];
+	};
+	std::stable_sort(order.begin(), order.end(), by_cost);
+	std::vector<std::vector<std::size_t>> result(num_workers);
+	std::vector<duration> load(num_workers, duration::zero());
+	for (const std::size_t d : order) {
+		const auto w = std::min_element(load.begin(), load.end());
+		*w += costs[d];
+		result[w - load.begin()].push_back(d);
+	}
+	return result;
+}
@@ -0,0 +1,39 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef COST_MODEL_H
+#define COST_MODEL_H
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+/*
+ * Estimated running time of each day. Estimates start from a static guess and
+ * are refined with an exponential moving average of the measured times, which
+ * is persisted between runs as lines of "day nanoseconds".
+ */
+class cost_model {
+public:
+	using duration = std::chrono::nanoseconds;
+
+	explicit cost_model(std::span<const duration> initial);
+
+	void read(std::istream& in);
+	void write(std::ostream& out) const;
+	void update(std::size_t day, duration measured);
+
+	[[nodiscard]] duration cost(const std::size_t day) const {
+		return costs.at(day);
+	}
+
+	[[nodiscard]] std::vector<std::vector<std::size_t>>
+	schedule(unsigned num_workers) const;
+
+private:
+	std::vector<duration> costs;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
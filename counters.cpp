@@ -0,0 +1,126 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "counters.h"
+
+std::optional<double> counter_values::ipc() const noexcept
+{
+	const auto& c = (*this)[hw_counter::cycles];
+	const auto& i = (*this)[hw_counter::instructions];
+	if (!c || !i || *c == 0)
+		return std::nullopt;
+	return static_cast<double>(*i) / static_cast<double>(*c);
+}
+
+std::ostream& operator<<(std::ostream& out, const counter_values& v)
+{
+	const auto print = [&out](const auto& x) -> std::ostream& {
+		return x ? out << *x : out << '-';
+	};
+	print(v[hw_counter::cycles]) << '\t';
+	print(v[hw_counter::instructions]) << '\t';
+	print(v.ipc()) << '\t';
+	print(v[hw_counter::l1d_misses]) << '\t';
+	print(v[hw_counter::llc_misses]) << '\t';
+	return print(v[hw_counter::branch_misses]);
+}
+
+#ifdef __linux__
+static constexpr std::uint64_t cache_miss(const std::uint64_t cache) noexcept
+{
+	return cache | PERF_COUNT_HW_CACHE_OP_READ << 8
+	       | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+}
+
+static constexpr struct {
+	std::uint32_t type;
+	std::uint64_t config;
+} events[num_hw_counters] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+static int open_event(const std::size_t i, const int group) noexcept
+{
+	perf_event_attr attr{};
+	attr.size = sizeof attr;
+	attr.type = events[i].type;
+	attr.config = events[i].config;
+	// Only the leader starts disabled; the others follow it
+	attr.disabled = group < 0;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, group,
+	                          PERF_FLAG_FD_CLOEXEC);
+	return static_cast<int>(fd);
+}
+
+perf_counters::perf_counters() noexcept
+{
+	fds[0] = open_event(0, -1);
+	if (fds[0] < 0) {
+		open_error = errno;
+		return;
+	}
+	// Events missing on this machine are left out of the group
+	for (std::size_t i = 1; i < num_hw_counters; ++i)
+		fds[i] = open_event(i, fds[0]);
+}
+
+perf_counters::~perf_counters()
+{
+	for (auto it = fds.rbegin(); it != fds.rend(); ++it) {
+		if (*it >= 0)
+			::close(*it);
+	}
+}
+
+void perf_counters::start() noexcept
+{
+	if (!available())
+		return;
+	::ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	::ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+counter_values perf_counters::stop() noexcept
+{
+	counter_values result;
+	if (!available())
+		return result;
+	::ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	for (std::size_t i = 0; i < num_hw_counters; ++i) {
+		std::uint64_t count;
+		if (fds[i] >= 0 && ::read(fds[i], &count, sizeof count)
+		                   == sizeof count)
+			result.values[i] = count;
+	}
+	return result;
+}
+#else
+perf_counters::perf_counters() noexcept
+	: open_error{ENOSYS}
+{}
+
+perf_counters::~perf_counters() = default;
+
+void perf_counters::start() noexcept {}
+
+counter_values perf_counters::stop() noexcept
+{
+	return {};
+}
+#endif
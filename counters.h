@@ -0,0 +1,67 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef COUNTERS_H
+#define COUNTERS_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+enum class hw_counter {
+	cycles,
+	instructions,
+	l1d_misses,
+	llc_misses,
+	branch_misses
+};
+
+inline constexpr std::size_t num_hw_counters = 5;
+
+// Header of the columns printed for counter_values
+inline constexpr std::string_view counter_columns =
+	"cycles\tinstr\tIPC\tL1d miss\tLLC miss\tbr miss";
+
+// Counts of one measurement; events the machine lacks have no value
+struct counter_values {
+	[[nodiscard]] constexpr const std::optional<std::uint64_t>&
+	operator[](const hw_counter c) const noexcept {
+		return values[static_cast<std::size_t>(c)];
+	}
+
+	[[nodiscard]] std::optional<double> ipc() const noexcept;
+
+	std::array<std::optional<std::uint64_t>, num_hw_counters> values{};
+};
+
+// Tab-separated counts and IPC, with a dash for every missing value
+std::ostream& operator<<(std::ostream& out, const counter_values& v);
+
+/*
+ * Group of hardware performance counters measuring the calling thread only,
+ * in user space. They are opened with perf_event_open on Linux; elsewhere, or
+ * when the kernel refuses, the group is unavailable and measures nothing.
+ */
+class perf_counters {
+public:
+	perf_counters() noexcept;
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+	~perf_counters();
+
+	[[nodiscard]] bool available() const noexcept { return fds[0] >= 0; }
+
+	// Why the group is unavailable
+	[[nodiscard]] int error() const noexcept { return open_error; }
+
+	void start() noexcept;
+	[[nodiscard]] counter_values stop() noexcept;
+
+private:
+	std::array<int, num_hw_counters> fds{-1, -1, -1, -1, -1};
+	int open_error = 0;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
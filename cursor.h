@@ -0,0 +1,123 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef CURSOR_H
+#define CURSOR_H
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/*
+ * Reading position in an in-memory input, for days which mostly read
+ * numbers. Unlike a stream, it has no locale and no sentry, and numbers do
+ * not skip the whitespace before them. A failed read leaves it in place.
+ */
+class cursor {
+public:
+	explicit constexpr cursor(const std::string_view s) noexcept
+		: pos{s.data()}
+		, last{s.data() + s.size()}
+	{}
+
+	[[nodiscard]] constexpr bool empty() const noexcept {
+		return pos == last;
+	}
+
+	// Returns '\0' at the end of the input
+	[[nodiscard]] constexpr char peek() const noexcept {
+		return pos != last ? *pos : '\0';
+	}
+
+	[[nodiscard]] constexpr std::string_view rest() const noexcept {
+		return {pos, static_cast<std::size_t>(last - pos)};
+	}
+
+	constexpr bool expect(const char c) noexcept {
+		if (pos == last || *pos != c)
+			return false;
+		++pos;
+		return true;
+	}
+
+	constexpr bool expect(const std::string_view s) noexcept {
+		if (!rest().starts_with(s))
+			return false;
+		pos += s.size();
+		return true;
+	}
+
+	constexpr void skip_ws() noexcept {
+		while (pos != last && (*pos == ' ' || *pos == '\n'
+		                       || *pos == '\t' || *pos == '\r'))
+			++pos;
+	}
+
+	template<std::unsigned_integral U>
+	constexpr bool read_uint(U& x) noexcept;
+
+	template<std::signed_integral I>
+	constexpr bool read_int(I& x) noexcept;
+
+private:
+	// Non-digits give 10 or more
+	static constexpr unsigned digit(const char c) noexcept {
+		return static_cast<unsigned char>(c) - unsigned{'0'};
+	}
+
+	const char *pos;
+	const char *last;
+};
+
+/*
+ * Up to digits10 digits cannot overflow, so they are accumulated without
+ * checking it. Each digit still costs three tests: for the end of the text,
+ * for being a digit, done with one unsigned comparison, and for the count.
+ * Longer numbers are left to std::from_chars to check the range.
+ */
+template<std::unsigned_integral U>
+constexpr bool cursor::read_uint(U& x) noexcept
+{
+	constexpr int safe_digits = std::numeric_limits<U>::digits10;
+	const char *p = pos;
+	U n = 0;
+	unsigned d;
+	while (p != last && (d = digit(*p)) < 10
+	       && p - pos < safe_digits) {
+		n = static_cast<U>(10 * n + d);
+		++p;
+	}
+	if (p == pos)
+		return false;
+	if (p != last && digit(*p) < 10) {
+		const auto [end, ec] = std::from_chars(pos, last, n);
+		if (ec != std::errc{})
+			return false;
+		p = end;
+	}
+	x = n;
+	pos = p;
+	return true;
+}
+
+template<std::signed_integral I>
+constexpr bool cursor::read_int(I& x) noexcept
+{
+	using U = std::make_unsigned_t<I>;
+	const char *const start = pos;
+	const bool negative = expect('-');
+	U m;
+	if (!read_uint(m)
+	    || m > static_cast<U>(std::numeric_limits<I>::max()) + negative) {
+		pos = start;
+		return false;
+	}
+	// Conversion to a signed type is modular
+	x = static_cast<I>(negative ? U{0} - m : m);
+	return true;
+}
+#endif
+#else
+#error This header is for C++20 or later
+#endif
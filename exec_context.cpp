@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "exec_context.h"
+
+namespace {
+/*
+ * Progress of one run_chunks call. Helpers keep it alive, since those still
+ * queued when the caller returns only find that no chunk is left.
+ */
+struct chunk_state {
+	using function_type =
+		std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+	chunk_state(const std::size_t size, const std::size_t count,
+	            const function_type& fn) noexcept
+		: n{size}
+		, chunks{count}
+		, f{fn}
+	{}
+
+	std::atomic<std::size_t> next = 0;
+	std::atomic<std::size_t> done = 0;
+	const std::size_t n;
+	const std::size_t chunks;
+	const function_type& f;
+	std::mutex error_mutex{};
+	std::exception_ptr error{};
+};
+}
+
+// Runs chunks until none is left to claim
+static void drain(chunk_state& s) noexcept
+{
+	std::size_t c;
+	while ((c = s.next.fetch_add(1, std::memory_order_relaxed)) < s.chunks) {
+		try {
+			s.f(c, s.n * c / s.chunks, s.n * (c + 1) / s.chunks);
+		} catch (...) {
+			const std::lock_guard lock{s.error_mutex};
+			if (!s.error)
+				s.error = std::current_exception();
+		}
+		if (s.done.fetch_add(1, std::memory_order_acq_rel) + 1
+		    == s.chunks)
+			s.done.notify_all();
+	}
+}
+
+exec_context& exec_context::serial() noexcept
+{
+	static exec_context context;
+	return context;
+}
+
+// A few chunks per thread, so that threads finishing early can take more
+std::size_t exec_context::chunk_count(const std::size_t n) const noexcept
+{
+	return std::min(n, std::size_t{4} * concurrency());
+}
+
+void exec_context::run_chunks(const std::size_t n, const std::size_t chunks,
+                              const chunk_function& f)
+{
+	if (!pool || chunks == 1) {
+		for (std::size_t c = 0; c < chunks; ++c)
+			f(c, n * c / chunks, n * (c + 1) / chunks);
+		return;
+	}
+	const auto s = std::make_shared<chunk_state>(n, chunks, f);
+	const std::size_t helpers = std::min<std::size_t>(pool->size() - 1,
+	                                                  chunks - 1);
+	// Idle threads take helpers before the days planned after this one
+	for (std::size_t i = 0; i < helpers; ++i)
+		pool->submit_helper([s] { drain(*s); });
+	drain(*s);
+	// Chunks claimed by helpers are already running, so this cannot hang
+	std::size_t d;
+	while ((d = s->done.load(std::memory_order_acquire)) < chunks)
+		s->done.wait(d, std::memory_order_acquire);
+	if (s->error)
+		std::rethrow_exception(s->error);
+}
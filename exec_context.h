@@ -0,0 +1,122 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef EXEC_CONTEXT_H
+#define EXEC_CONTEXT_H
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+// Thrown by days which notice that the runner asked them to stop
+class cancelled_error : public std::runtime_error {
+public:
+	using std::runtime_error::runtime_error;
+};
+
+/*
+ * Where a day may run parallel work, and how the runner asks it to stop. A
+ * context without a thread pool runs everything on the calling thread. With
+ * one, work is split into chunks which the caller starts working on right
+ * away while tasks on the pool help with the rest, so that a day called from
+ * a pool worker only borrows threads that would otherwise be idle instead of
+ * starting new ones.
+ *
+ * Long loops should call check_cancelled() now and then; the runner cannot
+ * interrupt a day that does not.
+ */
+class exec_context {
+public:
+	exec_context() noexcept = default;
+	explicit exec_context(thread_pool& p) noexcept : pool{&p} {}
+	exec_context(const exec_context&) = default;
+	exec_context& operator=(const exec_context&) = default;
+
+	// Same threads, but stopped through the given token
+	[[nodiscard]] exec_context with_stop(std::stop_token s) const noexcept {
+		exec_context c = *this;
+		c.stop = std::move(s);
+		return c;
+	}
+
+	[[nodiscard]] const std::stop_token& stop_token() const noexcept {
+		return stop;
+	}
+
+	void check_cancelled() const {
+		if (stop.stop_requested()) [[unlikely]]
+			throw cancelled_error("Cancelled");
+	}
+
+	// Context shared by everything running without a thread pool
+	[[nodiscard]] static exec_context& serial() noexcept;
+
+	[[nodiscard]] unsigned concurrency() const noexcept {
+		return pool ? pool->size() : 1;
+	}
+
+	// Calls f(i) for every i in [begin, end), in no particular order
+	template<class F>
+	void parallel_for(const std::size_t begin, const std::size_t end, F f) {
+		if (end <= begin)
+			return;
+		const std::size_t n = end - begin;
+		run_chunks(n, chunk_count(n),
+		           [&f, begin](std::size_t, const std::size_t lo,
+		                       const std::size_t hi) {
+			for (std::size_t i = lo; i < hi; ++i)
+				f(begin + i);
+		});
+	}
+
+	/*
+	 * Folds combine over init and map(i) for every i in [begin, end). The
+	 * grouping is unspecified, so combine must be associative, but the
+	 * order of the operands is kept.
+	 */
+	template<class T, class Map, class Combine>
+	[[nodiscard]] T parallel_reduce(const std::size_t begin,
+	                                const std::size_t end, T init, Map map,
+	                                Combine combine) {
+		if (end <= begin)
+			return init;
+		const std::size_t n = end - begin;
+		const std::size_t chunks = chunk_count(n);
+		std::vector<std::optional<T>> partial(chunks);
+		run_chunks(n, chunks,
+		           [&, begin](const std::size_t c, const std::size_t lo,
+		                      const std::size_t hi) {
+			T acc = map(begin + lo);
+			for (std::size_t i = lo + 1; i < hi; ++i)
+				acc = combine(std::move(acc), map(begin + i));
+			partial[c].emplace(std::move(acc));
+		});
+		for (std::optional<T>& p : partial)
+			init = combine(std::move(init), std::move(*p));
+		return init;
+	}
+
+private:
+	using chunk_function =
+		std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+	[[nodiscard]] std::size_t chunk_count(std::size_t n) const noexcept;
+
+	/*
+	 * Splits [0, n) into chunks nonempty ranges and calls f(chunk, lo, hi)
+	 * on each, returning once all of them are done. The first exception
+	 * thrown by f is rethrown.
+	 */
+	void run_chunks(std::size_t n, std::size_t chunks,
+	                const chunk_function& f);
+
+	thread_pool *pool = nullptr;
+	std::stop_token stop{};
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
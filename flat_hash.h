@@ -0,0 +1,432 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef FLAT_HASH_H
+#define FLAT_HASH_H
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Hashes for the keys of flat_hash_set and flat_hash_map: integers are taken
+ * as they are, and points, structures with integer members x and y, are
+ * packed into one word with y in its high half. The table then multiplies
+ * the word by a large odd constant and keeps the high bits of the product,
+ * which spreads such keys well enough.
+ */
+template<class Key>
+struct flat_hash;
+
+template<std::integral Key>
+struct flat_hash<Key> {
+	[[nodiscard]] constexpr std::uint64_t operator()(const Key k)
+		const noexcept
+	{
+		return static_cast<std::uint64_t>(k);
+	}
+};
+
+template<class P>
+concept flat_point = std::integral<decltype(P::x)>
+                     && std::integral<decltype(P::y)>;
+
+template<flat_point Key>
+struct flat_hash<Key> {
+	[[nodiscard]] constexpr std::uint64_t operator()(const Key& p)
+		const noexcept
+	{
+		return static_cast<std::uint64_t>(p.x)
+		       ^ std::rotl(static_cast<std::uint64_t>(p.y), 32);
+	}
+};
+
+namespace flat_hash_detail {
+
+/*
+ * Open addressing with linear probing, Robin Hood style: an element being
+ * inserted takes the place of any it meets which is closer to its own home
+ * slot, and the one displaced carries on. Probe lengths stay short and even,
+ * and a lookup stops as soon as it meets an element closer to home than the
+ * key would be.
+ *
+ * Erasing shifts the elements which follow back by one slot, up to one which
+ * is empty or at home, rather than leaving a marker: the table is then as if
+ * the element had never been inserted. Elements move when others are added or
+ * erased, so iterators and references are only stable until then. Clearing
+ * keeps the slots for the next use.
+ */
+template<class Key, class Value, class KeyOf, class Hash>
+	requires std::default_initializable<Value> && std::movable<Value>
+class table {
+	struct slot {
+		Value value{};
+		// 0 if empty, else 1 + distance from the home slot
+		std::uint8_t distance = 0;
+	};
+
+	using storage = std::pmr::vector<slot>;
+
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = std::size_t;
+
+	template<bool Const>
+	class basic_iterator {
+	public:
+		using value_type = table::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference =
+			std::conditional_t<Const, const value_type&, value_type&>;
+		using pointer =
+			std::conditional_t<Const, const value_type*, value_type*>;
+
+		basic_iterator() = default;
+
+		operator basic_iterator<true>() const noexcept
+			requires (!Const)
+		{
+			return {at, last};
+		}
+
+		[[nodiscard]] reference operator*() const noexcept {
+			return at->value;
+		}
+
+		[[nodiscard]] pointer operator->() const noexcept {
+			return &at->value;
+		}
+
+		basic_iterator& operator++() noexcept {
+			++at;
+			skip();
+			return *this;
+		}
+
+		basic_iterator operator++(int) noexcept {
+			basic_iterator old = *this;
+			++*this;
+			return old;
+		}
+
+		[[nodiscard]] bool operator==(const basic_iterator&)
+			const noexcept = default;
+
+	private:
+		friend table;
+		friend basic_iterator<!Const>;
+		using slot_pointer =
+			std::conditional_t<Const, const slot*, slot*>;
+
+		basic_iterator(const slot_pointer a, const slot_pointer l)
+			noexcept
+			: at{a}
+			, last{l}
+		{}
+
+		void skip() noexcept {
+			while (at != last && at->distance == 0)
+				++at;
+		}
+
+		slot_pointer at = nullptr;
+		slot_pointer last = nullptr;
+	};
+
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	table() = default;
+
+	explicit table(std::pmr::memory_resource *const r) : slots(r) {}
+
+	table(const table& other, std::pmr::memory_resource *const r)
+		: slots(other.slots, r)
+		, count{other.count}
+		, shift{other.shift}
+	{}
+
+	[[nodiscard]] size_type size() const noexcept { return count; }
+	[[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+	[[nodiscard]] iterator begin() noexcept {
+		iterator it{slots.data(), slots.data() + slots.size()};
+		it.skip();
+		return it;
+	}
+
+	[[nodiscard]] const_iterator begin() const noexcept {
+		const_iterator it{slots.data(), slots.data() + slots.size()};
+		it.skip();
+		return it;
+	}
+
+	[[nodiscard]] iterator end() noexcept {
+		slot *const last = slots.data() + slots.size();
+		return {last, last};
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept {
+		const slot *const last = slots.data() + slots.size();
+		return {last, last};
+	}
+
+	[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+	[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+	[[nodiscard]] iterator find(const Key& k) noexcept {
+		const size_type i = locate(k);
+		return i == npos ? end() : at(i);
+	}
+
+	[[nodiscard]] const_iterator find(const Key& k) const noexcept {
+		const size_type i = locate(k);
+		return i == npos ? end() : at(i);
+	}
+
+	[[nodiscard]] bool contains(const Key& k) const noexcept {
+		return locate(k) != npos;
+	}
+
+	std::pair<iterator, bool> insert(Value v) {
+		const Key& k = KeyOf{}(v);
+		const size_type i = locate(k);
+		if (i != npos)
+			return {at(i), false};
+		return {at(add(std::move(v))), true};
+	}
+
+	// Removes the element with key k, returning how many were removed
+	size_type erase(const Key& k) {
+		size_type i = locate(k);
+		if (i == npos)
+			return 0;
+		for (size_type j = next(i); slots[j].distance > 1;
+		     i = j, j = next(j)) {
+			slots[i].value = std::move(slots[j].value);
+			slots[i].distance =
+				static_cast<std::uint8_t>(slots[j].distance - 1);
+		}
+		slots[i] = slot{};
+		--count;
+		return 1;
+	}
+
+	// Makes room for n elements without growing again
+	void reserve(const size_type n) {
+		if (n > capacity_for(slots.size()))
+			rehash(std::bit_ceil(n + n / 7 + 1));
+	}
+
+	void clear() noexcept {
+		for (slot& s : slots) {
+			if (s.distance != 0)
+				s = slot{};
+		}
+		count = 0;
+	}
+
+protected:
+	// Element with key k, made by make() if there is none
+	template<class F>
+	std::pair<iterator, bool> find_or_add(const Key& k, F make) {
+		const size_type i = locate(k);
+		if (i != npos)
+			return {at(i), false};
+		return {at(add(make())), true};
+	}
+
+	[[nodiscard]] iterator unconst(const const_iterator it) noexcept {
+		return at(static_cast<size_type>(it.at - slots.data()));
+	}
+
+private:
+	static constexpr size_type npos = std::numeric_limits<size_type>::max();
+	// Stored distances stay below it, so that lookups end before it
+	static constexpr std::uint8_t max_distance =
+		std::numeric_limits<std::uint8_t>::max();
+
+	// At most 7/8 of the slots are used
+	[[nodiscard]] static constexpr size_type capacity_for(const size_type n)
+		noexcept
+	{
+		return n - n / 8;
+	}
+
+	[[nodiscard]] size_type home(const Key& k) const noexcept {
+		constexpr std::uint64_t golden = 0x9e3779b97f4a7c15;
+		return static_cast<size_type>((Hash{}(k) * golden) >> shift);
+	}
+
+	[[nodiscard]] size_type next(const size_type i) const noexcept {
+		return (i + 1) & (slots.size() - 1);
+	}
+
+	[[nodiscard]] iterator at(const size_type i) noexcept {
+		return {slots.data() + i, slots.data() + slots.size()};
+	}
+
+	[[nodiscard]] const_iterator at(const size_type i) const noexcept {
+		return {slots.data() + i, slots.data() + slots.size()};
+	}
+
+	[[nodiscard]] size_type locate(const Key& k) const noexcept {
+		if (slots.empty())
+			return npos;
+		size_type i = home(k);
+		for (std::uint8_t d = 1;; ++d, i = next(i)) {
+			const slot& s = slots[i];
+			if (s.distance < d)
+				return npos;
+			if (s.distance == d && KeyOf{}(s.value) == k)
+				return i;
+		}
+	}
+
+	// Inserts a value whose key is absent, returning where it ends up
+	size_type add(Value&& v) {
+		if (count + 1 > capacity_for(slots.size()))
+			rehash(slots.empty() ? 8 : 2 * slots.size());
+		size_type placed = npos;
+		size_type i = home(KeyOf{}(v));
+		for (std::uint8_t d = 1;; ++d, i = next(i)) {
+			if (d == max_distance) {
+				// Probing again in a larger table
+				const Key k = KeyOf{}(placed == npos
+				                      ? v : slots[placed].value);
+				rehash(2 * slots.size());
+				add(std::move(v));
+				return locate(k);
+			}
+			slot& s = slots[i];
+			if (s.distance == 0) {
+				s.value = std::move(v);
+				s.distance = d;
+				++count;
+				return placed == npos ? i : placed;
+			}
+			if (s.distance < d) {
+				std::swap(s.value, v);
+				std::swap(s.distance, d);
+				if (placed == npos)
+					placed = i;
+			}
+		}
+	}
+
+	void rehash(const size_type n) {
+		storage old(n, slots.get_allocator());
+		old.swap(slots);
+		count = 0;
+		shift = std::numeric_limits<std::uint64_t>::digits
+		        - std::countr_zero(n);
+		for (slot& s : old) {
+			if (s.distance != 0)
+				add(std::move(s.value));
+		}
+	}
+
+	storage slots{};
+	size_type count = 0;
+	int shift = 0;
+};
+
+template<class Key>
+struct identity {
+	[[nodiscard]] constexpr const Key& operator()(const Key& k)
+		const noexcept
+	{
+		return k;
+	}
+};
+
+template<class Pair>
+struct first {
+	[[nodiscard]] constexpr const typename Pair::first_type&
+	operator()(const Pair& p) const noexcept {
+		return p.first;
+	}
+};
+
+}
+
+template<class Key, class Hash = flat_hash<Key>>
+class flat_hash_set : public flat_hash_detail::table<
+	Key, Key, flat_hash_detail::identity<Key>, Hash
+> {
+	using base = flat_hash_detail::table<
+		Key, Key, flat_hash_detail::identity<Key>, Hash
+	>;
+
+public:
+	using base::base;
+
+	flat_hash_set(std::initializer_list<Key> keys,
+	              std::pmr::memory_resource *const r)
+		: base{r}
+	{
+		this->reserve(keys.size());
+		for (const Key& k : keys)
+			this->insert(k);
+	}
+};
+
+/*
+ * Elements are std::pair<Key, T>, with a key which must not be changed
+ * through an iterator.
+ */
+template<class Key, class T, class Hash = flat_hash<Key>>
+class flat_hash_map : public flat_hash_detail::table<
+	Key, std::pair<Key, T>, flat_hash_detail::first<std::pair<Key, T>>,
+	Hash
+> {
+	using base = flat_hash_detail::table<
+		Key, std::pair<Key, T>,
+		flat_hash_detail::first<std::pair<Key, T>>, Hash
+	>;
+
+public:
+	using mapped_type = T;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	using base::base;
+
+	T& operator[](const Key& k) {
+		return this->find_or_add(k, [&k] {
+			return std::pair<Key, T>{k, T{}};
+		}).first->second;
+	}
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& k, M&& m) {
+		auto r = this->find_or_add(k, [&k, &m] {
+			return std::pair<Key, T>{k, std::forward<M>(m)};
+		});
+		if (!r.second)
+			r.first->second = std::forward<M>(m);
+		return r;
+	}
+
+	// The hint is used when it already points to the key
+	template<class M>
+	iterator insert_or_assign(const const_iterator hint, const Key& k,
+	                          M&& m)
+	{
+		if (hint != this->cend() && hint->first == k) {
+			const iterator it = this->unconst(hint);
+			it->second = std::forward<M>(m);
+			return it;
+		}
+		return insert_or_assign(k, std::forward<M>(m)).first;
+	}
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
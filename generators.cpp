@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generators.h"
+
+using namespace std::literals;
+
+template<class T>
+static T uniform(std::mt19937_64& rng, const T min, const T max)
+{
+	return std::uniform_int_distribution<T>{min, max}(rng);
+}
+
+// Calories carried by elves, in groups separated by blank lines
+static void
+write_calories(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	std::size_t group = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		if (group == 0) {
+			if (i > 0)
+				out += '\n';
+			group = uniform<std::size_t>(rng, 1, 15);
+		}
+		out += std::to_string(uniform<unsigned>(rng, 1000, 60000));
+		out += '\n';
+		--group;
+	}
+}
+
+static void
+write_rounds(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		out += static_cast<char>("ABC"[uniform(rng, 0, 2)]);
+		out += ' ';
+		out += static_cast<char>("XYZ"[uniform(rng, 0, 2)]);
+		out += '\n';
+	}
+}
+
+static void write_section(std::string& out, std::mt19937_64& rng)
+{
+	const unsigned a = uniform(rng, 1u, 99u);
+	const unsigned b = uniform(rng, a, 99u);
+	out += std::to_string(a);
+	out += '-';
+	out += std::to_string(b);
+}
+
+static void
+write_sections(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		write_section(out, rng);
+		out += ',';
+		write_section(out, rng);
+		out += '\n';
+	}
+}
+
+/*
+ * Groups of three rucksacks. Each rucksack draws from letters of its own, so
+ * that the badge is the only item in all three, and its halves from two
+ * disjoint sets of those, so that they only share the item chosen for both.
+ */
+static void
+write_rucksacks(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	constexpr std::string_view items =
+		"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"sv;
+	std::string letters{items};
+	for (std::size_t g = 0; g < (n + 2) / 3; ++g) {
+		std::shuffle(letters.begin(), letters.end(), rng);
+		const char badge = letters.back();
+		for (std::size_t r = 0; r < 3; ++r) {
+			// 17 letters: the shared item, then 8 for each half
+			const std::string_view own =
+				std::string_view{letters}.substr(17 * r, 17);
+			const std::size_t half = uniform<std::size_t>(rng, 4, 16);
+			std::string first{own[0], badge};
+			std::string second{own[0]};
+			while (first.size() < half)
+				first += own[uniform<std::size_t>(rng, 1, 8)];
+			while (second.size() < half)
+				second += own[uniform<std::size_t>(rng, 9, 16)];
+			std::shuffle(first.begin(), first.end(), rng);
+			std::shuffle(second.begin(), second.end(), rng);
+			out += first;
+			out += second;
+			out += '\n';
+		}
+	}
+}
+
+// Repeats three letters so that both markers only come at the very end
+static void
+write_datastream(std::string& out, const std::size_t n, std::mt19937_64&)
+{
+	constexpr std::string_view end = "defghijklmnopq"sv;
+	for (std::size_t i = 0; i + end.size() < n; ++i)
+		out += "abc"[i % 3];
+	out += end;
+	out += '\n';
+}
+
+// Square forest of n by n trees
+static void
+write_forest(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t r = 0; r < n; ++r) {
+		for (std::size_t c = 0; c < n; ++c)
+			out += static_cast<char>('0' + uniform(rng, 0, 9));
+		out += '\n';
+	}
+}
+
+// Head motions of the rope, short enough that the tail follows closely
+static void
+write_motions(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		out += static_cast<char>("UDLR"[uniform(rng, 0, 3)]);
+		out += ' ';
+		out += std::to_string(uniform(rng, 1, 20));
+		out += '\n';
+	}
+}
+
+/*
+ * Program of the CPU, which may last as long as the screen has pixels, n
+ * cycles at most. X stays over the screen, so signal strengths are positive.
+ */
+static void
+write_program(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	const std::size_t cycles = std::min<std::size_t>(n, 240);
+	int x = 1;
+	for (std::size_t c = 0; c < cycles;) {
+		if (c + 2 > cycles || uniform(rng, 0, 2) == 0) {
+			out += "noop\n";
+			++c;
+			continue;
+		}
+		const int to = uniform(rng, 1, 38);
+		out += "addx ";
+		out += std::to_string(to - x);
+		out += '\n';
+		x = to;
+		c += 2;
+	}
+}
+
+/*
+ * Map n squares wide rising from a to z from west to east, each square up to
+ * two below the slope. The top row is the slope itself, which climbs at most
+ * one at a time from the start at its west end to the goal at its east end.
+ */
+static void
+write_heightmap(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	const std::size_t width = std::max<std::size_t>(n, 26);
+	const std::size_t height = std::max<std::size_t>(width * 2 / 7, 2);
+	for (std::size_t y = 0; y < height; ++y) {
+		for (std::size_t x = 0; x < width; ++x) {
+			const auto slope = static_cast<int>(x * 25 / (width - 1));
+			const int h = y == 0 ? slope
+			              : std::max(slope - uniform(rng, 0, 2), 0);
+			out += y == 0 && x == 0 ? 'S'
+			       : y == 0 && x + 1 == width ? 'E'
+			       : static_cast<char>('a' + h);
+		}
+		out += '\n';
+	}
+}
+
+static void write_packet(std::string& out, const int depth,
+                         std::mt19937_64& rng)
+{
+	if (depth == 0 || uniform(rng, 0, 2) == 0) {
+		out += std::to_string(uniform(rng, 0, 10));
+		return;
+	}
+	out += '[';
+	const int n = uniform(rng, 0, 5);
+	for (int i = 0; i < n; ++i) {
+		if (i > 0)
+			out += ',';
+		write_packet(out, depth - 1, rng);
+	}
+	out += ']';
+}
+
+// Pairs of packets nested up to four lists deep
+static void
+write_packets(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		if (i > 0)
+			out += '\n';
+		for (int k = 0; k < 2; ++k) {
+			out += '[';
+			write_packet(out, 3, rng);
+			out += "]\n";
+		}
+	}
+}
+
+/*
+ * Paths of rock made of horizontal and vertical segments, in a cave getting
+ * deeper with their number, since the sand of part 2 fills a triangle down
+ * to the floor.
+ */
+static void
+write_rocks(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	const int depth = 10 + static_cast<int>(n / 2);
+	for (std::size_t i = 0; i < n; ++i) {
+		int x = 500 + uniform(rng, -depth, depth);
+		int y = uniform(rng, 1, depth);
+		out += std::to_string(x);
+		out += ',';
+		out += std::to_string(y);
+		const int segments = uniform(rng, 1, 4);
+		for (int k = 0; k < segments; ++k) {
+			const int d = uniform(rng, -8, 8);
+			if (k % 2 == 0)
+				x += d;
+			else if (y + d >= 1)
+				y += d;
+			out += " -> ";
+			out += std::to_string(x);
+			out += ',';
+			out += std::to_string(y);
+		}
+		out += '\n';
+	}
+}
+
+/*
+ * At least 200 jets: the tower of a shorter random list may never reach a
+ * state the day takes as the start of a cycle.
+ */
+static void
+write_jets(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < std::max<std::size_t>(n, 200); ++i)
+		out += "<>"[uniform(rng, 0, 1)];
+	out += '\n';
+}
+
+// Distinct cubes filling about half of a box, so that both parts have work
+static void
+write_droplet(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	std::size_t side = 1;
+	while (side * side * side < 2 * n)
+		++side;
+	std::vector<bool> taken(side * side * side, false);
+	for (std::size_t i = 0; i < n;) {
+		const std::size_t c =
+			uniform<std::size_t>(rng, 0, taken.size() - 1);
+		if (taken[c])
+			continue;
+		taken[c] = true;
+		out += std::to_string(c % side);
+		out += ',';
+		out += std::to_string(c / side % side);
+		out += ',';
+		out += std::to_string(c / (side * side));
+		out += '\n';
+		++i;
+	}
+}
+
+// Square grove of n by n cells, about half of them elves
+static void
+write_grove(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t r = 0; r < n; ++r) {
+		for (std::size_t c = 0; c < n; ++c)
+			out += ".#"[uniform(rng, 0, 1)];
+		out += '\n';
+	}
+}
+
+/*
+ * Valley n cells wide inside its walls, at least 40, and a fifth as high,
+ * with a blizzard on two cells in five; in a lower valley, blizzards may fill
+ * a whole row or column for good. As in real inputs, the columns of the
+ * entrance and of the exit have no blizzard going up or down, which would
+ * leave the valley through them.
+ */
+static void
+write_valley(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	const std::size_t width = std::max<std::size_t>(n, 40);
+	const std::size_t height = width / 5;
+	out += "#.";
+	out.append(width, '#');
+	out += '\n';
+	for (std::size_t y = 0; y < height; ++y) {
+		out += '#';
+		for (std::size_t x = 0; x < width; ++x) {
+			const bool edge = x == 0 || x + 1 == width;
+			const int c = uniform(rng, 0, 9);
+			out += c >= 4 ? '.'
+			       : edge ? "<><>"[c]
+			       : "^v<>"[c];
+		}
+		out += "#\n";
+	}
+	out.append(width, '#');
+	out += ".#\n";
+}
+
+// Positive numbers except for the single zero the puzzle requires
+static void
+write_numbers(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	const std::size_t zero = uniform<std::size_t>(rng, 0, n - 1);
+	for (std::size_t i = 0; i < n; ++i) {
+		out += i == zero ? "0"s
+		                 : std::to_string(uniform(rng, 1, 9999));
+		out += '\n';
+	}
+}
+
+static void write_snafu(std::string& out, std::uint64_t x)
+{
+	std::string digits;
+	while (x > 0) {
+		const auto d = static_cast<unsigned>(x % 5);
+		digits += "012=-"[d];
+		x = x / 5 + (d >= 3);
+	}
+	out.append(digits.rbegin(), digits.rend());
+}
+
+static void
+write_fuel(std::string& out, const std::size_t n, std::mt19937_64& rng)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		write_snafu(out, uniform<std::uint64_t>(rng, 1, 10'000'000'000));
+		out += '\n';
+	}
+}
+
+static constexpr input_generator generators[] = {
+	{"lines"sv, 2250, write_calories},
+	{"rounds"sv, 2500, write_rounds},
+	{"rucksacks"sv, 300, write_rucksacks},
+	{"pairs"sv, 1000, write_sections},
+	{},
+	{"characters"sv, 4096, write_datastream},
+	{},
+	{"trees per side"sv, 99, write_forest},
+	{"motions"sv, 2000, write_motions},
+	{"cycles"sv, 240, write_program},
+	{},
+	{"columns"sv, 143, write_heightmap},
+	{"pairs"sv, 150, write_packets},
+	{"paths"sv, 150, write_rocks},
+	{}, {},
+	{"jets"sv, 10091, write_jets},
+	{"cubes"sv, 2800, write_droplet},
+	{},
+	{"numbers"sv, 5000, write_numbers},
+	{}, {},
+	{"cells per side"sv, 73, write_grove},
+	{"columns"sv, 120, write_valley},
+	{"numbers"sv, 120, write_fuel}
+};
+
+const input_generator* find_generator(const std::size_t day) noexcept
+{
+	if (day >= std::size(generators) || !generators[day].write)
+		return nullptr;
+	return &generators[day];
+}
+
+std::string generate_input(const input_generator& g, const std::size_t size,
+                           const std::uint64_t seed)
+{
+	std::mt19937_64 rng{seed};
+	std::string out;
+	g.write(out, size, rng);
+	return out;
+}
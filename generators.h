@@ -0,0 +1,40 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef GENERATORS_H
+#define GENERATORS_H
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+/*
+ * Writes random but valid puzzle inputs of a chosen size, so that days can be
+ * timed on inputs much larger than the real ones. Days 1 to 4, 6, 8 to 10, 12
+ * to 14, 17, 18, 20 and 23 to 25 have one. A random input for the others
+ * would seldom be valid, or would not make them work harder: the moves of day
+ * 5 must find crates, the session of day 7 must describe one tree, day 15
+ * must leave a single spot uncovered, day 21 must have one unknown in a
+ * solvable equation and the map of day 22 must fold into a cube, while days
+ * 11, 16 and 19 take as long as their few monkeys, valves and blueprints make
+ * them.
+ */
+struct input_generator {
+	using write_type = void (*)(std::string&, std::size_t,
+	                            std::mt19937_64&);
+
+	// What the size counts
+	std::string_view unit;
+	// Size of a real puzzle input
+	std::size_t real_size;
+	write_type write;
+};
+
+// Generator of the day counted from 0, or null if it has none
+[[nodiscard]] const input_generator* find_generator(std::size_t day) noexcept;
+
+[[nodiscard]] std::string
+generate_input(const input_generator& g, std::size_t size, std::uint64_t seed);
+#endif
+#else
+#error This header is for C++20 or later
+#endif
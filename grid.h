@@ -0,0 +1,206 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef GRID_H
+#define GRID_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+/*
+ * Two-dimensional array stored row by row and surrounded by pad rows and
+ * columns of border cells, so that the neighbors of any cell inside can be
+ * read without checking bounds. The cells start on a cache line and, when the
+ * size of T divides a line, rows are padded to whole lines so that each row
+ * starts on one too.
+ *
+ * Cells are addressed by coordinates, x from -pad to width + pad - 1 and
+ * likewise y, or by index; moving to a neighbor adds one of the offsets of
+ * neighbors() to an index.
+ */
+template<class T>
+	requires std::is_trivially_copyable_v<T>
+class grid {
+public:
+	using size_type = std::size_t;
+	using index_type = std::ptrdiff_t;
+
+	// Cells of a column, one stride apart
+	template<class U>
+	class strided_view {
+	public:
+		constexpr strided_view(U *const f, const index_type s,
+		                       const size_type n) noexcept
+			: first{f}
+			, step{s}
+			, count{n}
+		{}
+
+		[[nodiscard]] constexpr U& operator[](const size_type i)
+			const noexcept
+		{
+			return first[static_cast<index_type>(i) * step];
+		}
+
+		[[nodiscard]] constexpr size_type size() const noexcept {
+			return count;
+		}
+
+	private:
+		U *first;
+		index_type step;
+		size_type count;
+	};
+
+	grid() = default;
+	grid(size_type width, size_type height, T border, size_type pad = 1);
+	grid(const grid& other);
+	grid(grid&&) noexcept = default;
+	grid& operator=(const grid& other);
+	grid& operator=(grid&&) noexcept = default;
+
+	[[nodiscard]] constexpr size_type width() const noexcept { return w; }
+	[[nodiscard]] constexpr size_type height() const noexcept { return h; }
+
+	[[nodiscard]] constexpr index_type
+	index(const index_type x, const index_type y) const noexcept {
+		return origin + y * stride + x;
+	}
+
+	[[nodiscard]] T& operator[](const index_type i) noexcept {
+		return cells[i];
+	}
+
+	[[nodiscard]] const T& operator[](const index_type i) const noexcept {
+		return cells[i];
+	}
+
+	[[nodiscard]] T& operator()(const index_type x, const index_type y)
+		noexcept
+	{
+		return cells[index(x, y)];
+	}
+
+	[[nodiscard]] const T&
+	operator()(const index_type x, const index_type y) const noexcept {
+		return cells[index(x, y)];
+	}
+
+	// Cells inside a row, without its border
+	[[nodiscard]] std::span<T> row(const index_type y) noexcept {
+		return {cells.get() + index(0, y), w};
+	}
+
+	[[nodiscard]] std::span<const T> row(const index_type y)
+		const noexcept
+	{
+		return {cells.get() + index(0, y), w};
+	}
+
+	[[nodiscard]] strided_view<T> column(const index_type x) noexcept {
+		return {cells.get() + index(x, 0), stride, h};
+	}
+
+	[[nodiscard]] strided_view<const T> column(const index_type x)
+		const noexcept
+	{
+		return {cells.get() + index(x, 0), stride, h};
+	}
+
+	// Up, left, right and down
+	[[nodiscard]] constexpr std::array<index_type, 4> neighbors()
+		const noexcept
+	{
+		return {-stride, -1, 1, stride};
+	}
+
+	// Sets every cell inside, leaving the border as is
+	void fill(const T value) noexcept {
+		for (size_type y = 0; y < h; ++y) {
+			const std::span<T> r = row(static_cast<index_type>(y));
+			std::fill(r.begin(), r.end(), value);
+		}
+	}
+
+private:
+	static constexpr std::align_val_t alignment{
+		std::max<size_type>(64, alignof(T))
+	};
+
+	struct deleter {
+		void operator()(T *const p) const noexcept {
+			::operator delete(p, alignment);
+		}
+	};
+
+	[[nodiscard]] size_type size() const noexcept {
+		return static_cast<size_type>(stride) * (h + 2 * pad_size());
+	}
+
+	[[nodiscard]] size_type pad_size() const noexcept {
+		return static_cast<size_type>(pad);
+	}
+
+	void allocate() {
+		cells.reset(static_cast<T *>(
+			::operator new(size() * sizeof(T), alignment)
+		));
+	}
+
+	size_type w = 0;
+	size_type h = 0;
+	index_type pad = 0;
+	index_type stride = 0;
+	index_type origin = 0;
+	std::unique_ptr<T[], deleter> cells{};
+};
+
+template<class T>
+	requires std::is_trivially_copyable_v<T>
+grid<T>::grid(const size_type width, const size_type height, const T border,
+              const size_type p)
+	: w{width}
+	, h{height}
+	, pad{static_cast<index_type>(p)}
+{
+	constexpr size_type line = static_cast<size_type>(alignment);
+	size_type s = w + 2 * p;
+	if (line % sizeof(T) == 0) {
+		const size_type per_line = line / sizeof(T);
+		s = (s + per_line - 1) / per_line * per_line;
+	}
+	stride = static_cast<index_type>(s);
+	origin = pad * stride + pad;
+	allocate();
+	std::uninitialized_fill_n(cells.get(), size(), border);
+}
+
+template<class T>
+	requires std::is_trivially_copyable_v<T>
+grid<T>::grid(const grid& other)
+	: w{other.w}
+	, h{other.h}
+	, pad{other.pad}
+	, stride{other.stride}
+	, origin{other.origin}
+{
+	if (!other.cells)
+		return;
+	allocate();
+	std::uninitialized_copy_n(other.cells.get(), size(), cells.get());
+}
+
+template<class T>
+	requires std::is_trivially_copyable_v<T>
+grid<T>& grid<T>::operator=(const grid& other)
+{
+	if (this != &other)
+		*this = grid(other);
+	return *this;
+}
+#endif
+#else
+#error This header is for C++20 or later
+#endif
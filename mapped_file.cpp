@@ -0,0 +1,65 @@
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+mapped_file::mapped_file(const std::string& path, const bool prefault)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) [[unlikely]]
+		throw std::system_error(errno, std::generic_category(), path);
+	try {
+		map(fd, prefault);
+	} catch (...) {
+		::close(fd);
+		throw;
+	}
+	// The mapping stays valid once the descriptor is closed
+	::close(fd);
+}
+
+mapped_file::mapped_file(const int fd)
+{
+	map(fd);
+}
+
+mapped_file::~mapped_file()
+{
+	if (size > 0)
+		::munmap(const_cast<char *>(data), size);
+}
+
+bool mapped_file::is_mappable(const int fd) noexcept
+{
+	struct stat st;
+	return ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+void mapped_file::map(const int fd, const bool prefault)
+{
+	struct stat st;
+	if (::fstat(fd, &st) != 0) [[unlikely]]
+		throw std::system_error(errno, std::generic_category(), "fstat");
+	if (!S_ISREG(st.st_mode)) [[unlikely]]
+		throw std::system_error(EINVAL, std::generic_category(),
+		                        "Only regular files can be mapped");
+	// Empty files cannot be mapped and keep the empty view
+	if (st.st_size == 0)
+		return;
+	const auto length = static_cast<std::size_t>(st.st_size);
+	const int flags = MAP_PRIVATE | (prefault ? MAP_POPULATE : 0);
+	void *const p = ::mmap(nullptr, length, PROT_READ, flags, fd, 0);
+	if (p == MAP_FAILED) [[unlikely]]
+		throw std::system_error(errno, std::generic_category(), "mmap");
+	// Days read their input front to back exactly once
+	::madvise(p, length, MADV_SEQUENTIAL);
+	data = static_cast<const char *>(p);
+	size = length;
+}
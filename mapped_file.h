@@ -0,0 +1,37 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ * Read-only memory mapping of a whole regular file, so that its contents can
+ * be parsed in place without copying them into a stream buffer.
+ */
+class mapped_file {
+public:
+	// Pre-faulting reads the whole file in before the constructor returns
+	explicit mapped_file(const std::string& path, bool prefault = false);
+	explicit mapped_file(int fd);
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+	~mapped_file();
+
+	// Only regular files can be mapped, not pipes or terminals
+	[[nodiscard]] static bool is_mappable(int fd) noexcept;
+
+	[[nodiscard]] std::string_view view() const noexcept {
+		return {data, size};
+	}
+
+private:
+	void map(int fd, bool prefault = false);
+
+	const char *data = "";
+	std::size_t size = 0;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,73 @@
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+#include "prefetch.h"
+
+input_prefetch::input_prefetch(std::vector<std::string> p,
+                               const std::vector<std::size_t>& order,
+                               const std::size_t d)
+	: paths{std::move(p)}
+	, depth{d > 0 ? d : 1}
+	, slots(paths.size())
+	, thread{[this, order](std::stop_token s) { run(std::move(s), order); }}
+{}
+
+std::unique_ptr<mapped_file> input_prefetch::take(const std::size_t i)
+{
+	std::unique_lock lock{mutex};
+	slot& s = slots.at(i);
+	if (s.status == state::pending) {
+		s.status = state::taken;
+		lock.unlock();
+		return std::make_unique<mapped_file>(paths[i]);
+	}
+	changed.wait(lock, [&s] { return s.status == state::ready; });
+	s.status = state::taken;
+	--ready;
+	std::unique_ptr<mapped_file> file = std::move(s.file);
+	const std::exception_ptr error = std::move(s.error);
+	lock.unlock();
+	changed.notify_all();
+	if (error)
+		std::rethrow_exception(error);
+	return file;
+}
+
+void input_prefetch::run(const std::stop_token stop,
+                         const std::vector<std::size_t> order)
+{
+	for (const std::size_t i : order) {
+		{
+			std::unique_lock lock{mutex};
+			if (!changed.wait(lock, stop,
+			                  [this] { return ready < depth; }))
+				return;
+			if (slots[i].status != state::pending)
+				continue;
+			slots[i].status = state::loading;
+		}
+		std::unique_ptr<mapped_file> file;
+		std::exception_ptr error;
+		try {
+			file = std::make_unique<mapped_file>(paths[i], true);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		{
+			const std::lock_guard lock{mutex};
+			slots[i].file = std::move(file);
+			slots[i].error = std::move(error);
+			slots[i].status = state::ready;
+			++ready;
+		}
+		changed.notify_all();
+	}
+}
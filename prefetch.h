@@ -0,0 +1,56 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef PREFETCH_H
+#define PREFETCH_H
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.h"
+
+/*
+ * Thread mapping and pre-faulting input files in the order tasks are expected
+ * to need them, while earlier tasks are computing. It stays at most a given
+ * number of files ahead of the tasks taking them. A task asking for a file
+ * the thread has not started on maps it itself rather than wait.
+ */
+class input_prefetch {
+public:
+	input_prefetch(std::vector<std::string> paths,
+	               const std::vector<std::size_t>& order,
+	               std::size_t depth);
+	input_prefetch(const input_prefetch&) = delete;
+	input_prefetch& operator=(const input_prefetch&) = delete;
+
+	// Each file is taken once, rethrowing what mapping it threw if anything
+	[[nodiscard]] std::unique_ptr<mapped_file> take(std::size_t i);
+
+private:
+	enum class state { pending, loading, ready, taken };
+
+	struct slot {
+		state status = state::pending;
+		std::unique_ptr<mapped_file> file{};
+		std::exception_ptr error{};
+	};
+
+	void run(std::stop_token stop, std::vector<std::size_t> order);
+
+	std::vector<std::string> paths;
+	std::size_t depth;
+	std::mutex mutex{};
+	std::condition_variable_any changed{};
+	std::vector<slot> slots;
+	// Files mapped but not taken yet
+	std::size_t ready = 0;
+	std::jthread thread;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,112 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef REGISTRY_H
+#define REGISTRY_H
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "common.h"
+#include "exec_context.h"
+
+template<> std::unique_ptr<parsed_input> parse<1>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<2>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<3>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<4>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<5>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<6>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<7>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<8>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<9>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<10>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<11>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<12>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<13>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<14>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<15>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<16>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<17>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<18>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<19>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<20>(std::string_view in);
+template<> std::unique_ptr<parsed_input> parse<21>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<22>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<23>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<24>(std::istream& in);
+template<> std::unique_ptr<parsed_input> parse<25>(std::string_view in);
+
+// What the runners know about a day before running it
+struct day_traits {
+	// Static guess of the running time, until it is measured
+	std::chrono::milliseconds expected_cost;
+	/*
+	 * The day can spread its work over the runner's threads. Benchmark and
+	 * scaling runs start no thread pool for the others, and batch runs give
+	 * them none to split an input over.
+	 */
+	bool parallel;
+	// Part 2 does not reuse the state part 1 leaves behind
+	bool independent_parts;
+};
+
+namespace registry_detail {
+using namespace std::literals;
+
+inline constexpr day_traits traits[] = {
+	{3ms, false, true},
+	{4ms, false, true},
+	{5ms, false, true},
+	{3ms, false, true},
+	{3ms, false, true},
+	{4ms, false, true},
+	{5ms, false, true},
+	{3ms, false, true},
+	{12ms, false, true},
+	{3ms, false, true},
+	{24ms, false, true},
+	{9ms, false, true},
+	{26ms, false, true},
+	{820ms, false, false},
+	{5387ms, true, true},
+	{5463ms, false, false},
+	{37ms, false, false},
+	{28ms, false, true},
+	{608ms, true, true},
+	{215ms, false, true},
+	{37ms, false, true},
+	{14ms, false, true},
+	{17639ms, false, false},
+	{747ms, false, true},
+	{3ms, false, true}
+};
+}
+
+struct day_info {
+	int number;
+	output_pair (*solve)(std::string_view, exec_context&);
+	std::unique_ptr<parsed_input> (*parse)(std::string_view);
+	day_traits traits;
+};
+
+inline constexpr std::size_t ndays = std::size(registry_detail::traits);
+
+namespace registry_detail {
+template<int... I>
+constexpr std::array<day_info, sizeof...(I)>
+make_registry(std::integer_sequence<int, I...>) noexcept
+{
+	return {day_info{I + 1, day<I + 1>, parse<I + 1>, traits[I]}...};
+}
+}
+
+// Every day, indexed from 0
+inline constexpr std::array<day_info, ndays> days =
+	registry_detail::make_registry(
+		std::make_integer_sequence<int, static_cast<int>(ndays)>{});
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,111 @@
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "mapped_file.h"
+#include "result_cache.h"
+
+// 64-bit FNV-1a, chained through seed
+static std::uint64_t
+hash(const std::string_view s,
+     std::uint64_t seed = UINT64_C(0xcbf29ce484222325)) noexcept
+{
+	for (const char c : s) {
+		seed ^= static_cast<unsigned char>(c);
+		seed *= UINT64_C(0x100000001b3);
+	}
+	return seed;
+}
+
+// Identifies the build through its executable, or its compilation time
+static std::uint64_t current_build() noexcept
+{
+	try {
+		const mapped_file exe{"/proc/self/exe"};
+		return hash(exe.view());
+	} catch (const std::exception&) {
+		return hash(__DATE__ " " __TIME__);
+	}
+}
+
+result_cache::result_cache(std::filesystem::path dir)
+	: directory{std::move(dir)}
+	, build_id{current_build()}
+{
+	std::filesystem::create_directories(directory);
+}
+
+std::filesystem::path
+result_cache::entry(const std::size_t day, const std::string_view input) const
+{
+	std::ostringstream name;
+	name << (day + 1) << '-' << std::hex << std::setfill('0')
+	     << std::setw(16) << hash(input, build_id);
+	return directory / name.str();
+}
+
+/*
+ * Answers are stored as their length in characters, a newline and the text.
+ * A length which is not a number or runs past the end of the entry means the
+ * entry is corrupt.
+ */
+static bool read_answer(std::string_view& in, std::string& s)
+{
+	const char *const last = in.data() + in.size();
+	std::size_t n;
+	const auto [end, e] = std::from_chars(in.data(), last, n);
+	if (e != std::errc{} || end == last || *end != '\n')
+		return false;
+	in.remove_prefix(static_cast<std::size_t>(end - in.data()) + 1);
+	if (n > in.size())
+		return false;
+	s = in.substr(0, n);
+	in.remove_prefix(n);
+	return true;
+}
+
+// A corrupt entry is a miss, and storing the answers again replaces it
+std::optional<result_cache::answers>
+result_cache::find(const std::size_t day, const std::string_view input) const
+{
+	std::ifstream f{entry(day, input), std::ios::binary};
+	if (!f)
+		return std::nullopt;
+	std::ostringstream s;
+	s << f.rdbuf();
+	const std::string text = std::move(s).str();
+	std::string_view rest = text;
+	answers a;
+	if (!read_answer(rest, a.first) || !read_answer(rest, a.second)
+	    || !rest.empty())
+		return std::nullopt;
+	return a;
+}
+
+bool result_cache::store(const std::size_t day, const std::string_view input,
+                         const answers& a) const
+{
+	const std::filesystem::path path = entry(day, input);
+	std::filesystem::path temp = path;
+	temp += ".tmp";
+	{
+		std::ofstream f{temp, std::ios::binary};
+		f << a.first.size() << '\n' << a.first
+		  << a.second.size() << '\n' << a.second;
+		if (!f.flush()) [[unlikely]]
+			return false;
+	}
+	// Readers only ever see complete entries
+	std::error_code e;
+	std::filesystem::rename(temp, path, e);
+	return !e;
+}
@@ -0,0 +1,40 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/*
+ * On-disk cache of formatted answers, one file per day and input. Entries are
+ * named after a hash of the input and of the running executable, so changing
+ * either one misses the cache instead of returning stale answers.
+ */
+class result_cache {
+public:
+	using answers = std::pair<std::string, std::string>;
+
+	explicit result_cache(std::filesystem::path dir);
+
+	[[nodiscard]] std::optional<answers>
+	find(std::size_t day, std::string_view input) const;
+
+	// Returns false when the entry could not be written
+	bool store(std::size_t day, std::string_view input,
+	           const answers& a) const;
+
+private:
+	[[nodiscard]] std::filesystem::path
+	entry(std::size_t day, std::string_view input) const;
+
+	std::filesystem::path directory;
+	std::uint64_t build_id;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,89 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef RESULT_SLOT_H
+#define RESULT_SLOT_H
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+
+#ifdef __cpp_lib_hardware_interference_size
+// The value may differ between compilers, which is fine within one program
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+inline constexpr std::size_t cache_line_size =
+	std::hardware_destructive_interference_size;
+#pragma GCC diagnostic pop
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+/*
+ * Holds the result of one task, written once by the worker that ran it and
+ * read by one collector. Each slot fills whole cache lines, so workers
+ * filling neighbouring slots of an array never share a line. The value is
+ * published with a release store and waited for with acquire loads, without
+ * any mutex.
+ */
+template<class T>
+class alignas(cache_line_size) result_slot {
+public:
+	result_slot() = default;
+	result_slot(const result_slot&) = delete;
+	result_slot& operator=(const result_slot&) = delete;
+
+	// Must be called exactly once
+	void publish(T&& x) {
+		value.emplace(std::move(x));
+		ready.store(true, std::memory_order_release);
+		ready.notify_one();
+	}
+
+	// Blocks until the value is published, then moves it out
+	[[nodiscard]] T take() {
+		ready.wait(false, std::memory_order_acquire);
+		return std::move(*value);
+	}
+
+private:
+	std::optional<T> value{};
+	std::atomic<bool> ready = false;
+};
+
+/*
+ * Indices of the tasks among N in the order they finished, pushed by the
+ * workers and popped by one collector. Each push claims the next entry with
+ * an atomic increment, so no two workers wait for each other.
+ */
+template<std::size_t N>
+class completion_queue {
+public:
+	completion_queue() = default;
+	completion_queue(const completion_queue&) = delete;
+	completion_queue& operator=(const completion_queue&) = delete;
+
+	// Must be called once per task
+	void push(const std::size_t index) noexcept {
+		const std::size_t i = tail.fetch_add(1,
+		                                     std::memory_order_relaxed);
+		// Zero marks an empty entry
+		entries[i].store(index + 1, std::memory_order_release);
+		entries[i].notify_one();
+	}
+
+	// Blocks until another task is done and returns its index
+	[[nodiscard]] std::size_t pop() noexcept {
+		std::atomic<std::size_t>& e = entries[head++];
+		e.wait(0, std::memory_order_acquire);
+		return e.load(std::memory_order_acquire) - 1;
+	}
+
+private:
+	std::atomic<std::size_t> entries[N]{};
+	alignas(cache_line_size) std::atomic<std::size_t> tail = 0;
+	std::size_t head = 0;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
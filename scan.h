@@ -0,0 +1,199 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef SCAN_H
+#define SCAN_H
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+// String literal usable as a template argument
+template<std::size_t N>
+struct fixed_string {
+	constexpr fixed_string(const char (&s)[N]) noexcept {
+		for (std::size_t i = 0; i < N; ++i)
+			data[i] = s[i];
+	}
+
+	[[nodiscard]] constexpr std::string_view view() const noexcept {
+		return {data, N - 1};
+	}
+
+	char data[N];
+};
+
+namespace scan_detail {
+enum class token_kind { literal, space, value };
+
+struct token {
+	token_kind kind;
+	std::string_view text;
+	std::size_t arg;
+};
+
+constexpr bool is_space(const char c) noexcept
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+constexpr void skip_space(std::string_view& in) noexcept
+{
+	std::size_t i = 0;
+	while (i < in.size() && is_space(in[i]))
+		++i;
+	in.remove_prefix(i);
+}
+
+template<fixed_string P>
+constexpr std::size_t token_count() noexcept
+{
+	constexpr std::string_view p = P.view();
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < p.size(); ++n) {
+		if (p.substr(i).starts_with("{}")) {
+			i += 2;
+		} else if (p[i] == ' ') {
+			while (i < p.size() && p[i] == ' ')
+				++i;
+		} else {
+			while (i < p.size() && p[i] != ' '
+			       && !p.substr(i).starts_with("{}"))
+				++i;
+		}
+	}
+	return n;
+}
+
+/*
+ * Splits the pattern into literal text, runs of spaces (matching any amount
+ * of whitespace, as in scanf) and {} placeholders.
+ */
+template<fixed_string P>
+constexpr std::array<token, token_count<P>()> tokenize() noexcept
+{
+	constexpr std::string_view p = P.view();
+	std::array<token, token_count<P>()> t{};
+	std::size_t n = 0;
+	std::size_t arg = 0;
+	for (std::size_t i = 0; i < p.size(); ++n) {
+		const std::size_t start = i;
+		if (p.substr(i).starts_with("{}")) {
+			i += 2;
+			t[n] = {token_kind::value, {}, arg++};
+		} else if (p[i] == ' ') {
+			while (i < p.size() && p[i] == ' ')
+				++i;
+			t[n] = {token_kind::space, {}, 0};
+		} else {
+			while (i < p.size() && p[i] != ' '
+			       && !p.substr(i).starts_with("{}"))
+				++i;
+			t[n] = {token_kind::literal, p.substr(start, i - start), 0};
+		}
+	}
+	return t;
+}
+
+template<fixed_string P>
+inline constexpr auto tokens = tokenize<P>();
+
+template<fixed_string P>
+constexpr std::size_t value_count() noexcept
+{
+	std::size_t n = 0;
+	for (const token& t : tokens<P>)
+		n += t.kind == token_kind::value;
+	return n;
+}
+
+// Character ending a word placeholder besides whitespace, if any
+template<fixed_string P, std::size_t T>
+constexpr char word_end() noexcept
+{
+	if constexpr (T + 1 < tokens<P>.size()) {
+		constexpr token next = tokens<P>[T + 1];
+		if constexpr (next.kind == token_kind::literal)
+			return next.text.front();
+	}
+	return ' ';
+}
+
+template<std::integral I>
+bool read_value(std::string_view& in, I& x, char) noexcept
+{
+	const auto [end, e] = std::from_chars(in.data(),
+	                                      in.data() + in.size(), x);
+	if (e != std::errc{})
+		return false;
+	in.remove_prefix(static_cast<std::size_t>(end - in.data()));
+	return true;
+}
+
+inline bool read_value(std::string_view& in, char& c, char) noexcept
+{
+	if (in.empty())
+		return false;
+	c = in.front();
+	in.remove_prefix(1);
+	return true;
+}
+
+// A word runs up to whitespace or the text following it in the pattern
+inline bool
+read_value(std::string_view& in, std::string_view& w, const char end) noexcept
+{
+	std::size_t n = 0;
+	while (n < in.size() && !is_space(in[n]) && in[n] != end)
+		++n;
+	if (n == 0)
+		return false;
+	w = in.substr(0, n);
+	in.remove_prefix(n);
+	return true;
+}
+
+template<fixed_string P, std::size_t T, class Args>
+bool match(std::string_view& in, Args& args) noexcept
+{
+	constexpr token t = tokens<P>[T];
+	if constexpr (t.kind == token_kind::literal) {
+		// The length is a constant, so this compiles to a fixed compare
+		if (!in.starts_with(t.text))
+			return false;
+		in.remove_prefix(t.text.size());
+		return true;
+	} else if constexpr (t.kind == token_kind::space) {
+		skip_space(in);
+		return true;
+	} else {
+		return read_value(in, std::get<t.arg>(args), word_end<P, T>());
+	}
+}
+}
+
+/*
+ * Matches the start of the input against the pattern P and removes what
+ * matched. Literal text must appear as is, a run of spaces matches any amount
+ * of whitespace, including none, and each {} reads the next argument: an
+ * integer (with std::from_chars), a single char, or a std::string_view word.
+ * The pattern is split at compile time, so matching it is straight-line code.
+ * On failure, returns false and leaves the input partially consumed.
+ */
+template<fixed_string P, class... Args>
+[[nodiscard]] bool scan(std::string_view& in, Args&... args) noexcept
+{
+	using namespace scan_detail;
+	static_assert(sizeof...(Args) == value_count<P>(),
+	              "Pattern and arguments do not match");
+	std::tuple<Args&...> refs{args...};
+	return [&]<std::size_t... T>(std::index_sequence<T...>) {
+		return (match<P, T>(in, refs) && ...);
+	}(std::make_index_sequence<tokens<P>.size()>{});
+}
+#endif
+#else
+#error This header is for C++20 or later
+#endif
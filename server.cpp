@@ -0,0 +1,341 @@
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+
+namespace {
+// Closes the descriptor when leaving the scope
+class socket_fd {
+public:
+	explicit socket_fd(const int f) noexcept : fd{f} {}
+	socket_fd(const socket_fd&) = delete;
+	socket_fd& operator=(const socket_fd&) = delete;
+
+	~socket_fd() {
+		if (fd >= 0)
+			::close(fd);
+	}
+
+	[[nodiscard]] int get() const noexcept { return fd; }
+
+private:
+	int fd;
+};
+}
+
+[[noreturn]] static void throw_errno(const char *what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+static sockaddr_un make_address(const std::string& path)
+{
+	sockaddr_un addr{};
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof addr.sun_path) [[unlikely]]
+		throw std::invalid_argument("Socket path is too long");
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+	return addr;
+}
+
+static int open_socket()
+{
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) [[unlikely]]
+		throw_errno("socket");
+	return fd;
+}
+
+// False if the peer closed the connection before sending anything
+static bool read_all(const int fd, void *const buf, const std::size_t n)
+{
+	auto p = static_cast<char *>(buf);
+	std::size_t done = 0;
+	while (done < n) {
+		const ssize_t r = ::recv(fd, p + done, n - done, 0);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			throw_errno("recv");
+		}
+		if (r == 0) {
+			if (done == 0)
+				return false;
+			throw std::runtime_error("Truncated frame");
+		}
+		done += static_cast<std::size_t>(r);
+	}
+	return true;
+}
+
+static void write_all(const int fd, const void *const buf, const std::size_t n)
+{
+	auto p = static_cast<const char *>(buf);
+	std::size_t done = 0;
+	while (done < n) {
+		// The peer hanging up must not kill the whole process
+		const ssize_t r = ::send(fd, p + done, n - done, MSG_NOSIGNAL);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			throw_errno("send");
+		}
+		done += static_cast<std::size_t>(r);
+	}
+}
+
+static void write_string(const int fd, const std::string_view s)
+{
+	const std::uint64_t n = s.size();
+	write_all(fd, &n, sizeof n);
+	write_all(fd, s.data(), s.size());
+}
+
+static std::string read_string(const int fd)
+{
+	std::uint64_t n;
+	if (!read_all(fd, &n, sizeof n))
+		throw std::runtime_error("Truncated frame");
+	if (n > max_request_size) [[unlikely]]
+		throw std::runtime_error("Frame too large");
+	std::string s(static_cast<std::size_t>(n), '\0');
+	if (n > 0 && !read_all(fd, s.data(), s.size()))
+		throw std::runtime_error("Truncated frame");
+	return s;
+}
+
+namespace {
+// Bytes received on a connection, and whether a request of it is being solved
+struct connection {
+	explicit connection(const int f) noexcept : fd{f} {}
+
+	socket_fd fd;
+	std::string pending{};
+	// One request at a time, so that replies keep the order of requests
+	bool busy = false;
+};
+
+/*
+ * Connections whose request has been answered, handed back by the pool to
+ * the thread reading requests. Posting writes to a pipe, which wakes it.
+ */
+class mailbox {
+public:
+	mailbox() : mailbox{make_pipe()} {}
+
+	[[nodiscard]] int fd() const noexcept { return read_end.get(); }
+
+	// keep is false if the connection failed and must be dropped
+	void post(const int conn, const bool keep) {
+		{
+			const std::lock_guard lock{m};
+			done.emplace_back(conn, keep);
+		}
+		const char c = 0;
+		// A full pipe wakes the reader just as well
+		[[maybe_unused]] const ssize_t r =
+			::write(write_end.get(), &c, sizeof c);
+	}
+
+	[[nodiscard]] std::vector<std::pair<int, bool>> take() {
+		std::array<char, 64> buf;
+		while (::read(read_end.get(), buf.data(), buf.size()) > 0) {}
+		const std::lock_guard lock{m};
+		return std::exchange(done, {});
+	}
+
+private:
+	explicit mailbox(const std::array<int, 2> p) noexcept
+		: read_end{p[0]}
+		, write_end{p[1]}
+	{}
+
+	static std::array<int, 2> make_pipe() {
+		std::array<int, 2> p;
+		if (::pipe2(p.data(), O_CLOEXEC | O_NONBLOCK) != 0) [[unlikely]]
+			throw_errno("pipe2");
+		return p;
+	}
+
+	socket_fd read_end;
+	socket_fd write_end;
+	std::mutex m{};
+	std::vector<std::pair<int, bool>> done{};
+};
+}
+
+// Appends what has arrived; false once the peer has hung up
+static bool receive(const int fd, std::string& pending)
+{
+	std::array<char, 1 << 16> buf;
+	const ssize_t r = ::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT);
+	if (r < 0)
+		return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+	if (r == 0)
+		return false;
+	pending.append(buf.data(), static_cast<std::size_t>(r));
+	return true;
+}
+
+struct request_frame {
+	std::uint32_t day;
+	std::string input;
+};
+
+// Removes the first request from pending once it has arrived whole
+static std::optional<request_frame> take_request(std::string& pending)
+{
+	std::uint32_t day;
+	std::uint64_t n;
+	constexpr std::size_t header = sizeof day + sizeof n;
+	if (pending.size() < header)
+		return std::nullopt;
+	std::memcpy(&day, pending.data(), sizeof day);
+	std::memcpy(&n, pending.data() + sizeof day, sizeof n);
+	if (n > max_request_size) [[unlikely]]
+		throw std::runtime_error("Frame too large");
+	if (pending.size() - header < n)
+		return std::nullopt;
+	request_frame r{day, pending.substr(header, static_cast<std::size_t>(n))};
+	pending.erase(0, header + static_cast<std::size_t>(n));
+	return r;
+}
+
+static void answer_request(const int fd, const request_frame& r,
+                           const solver_type& solve, mailbox& replies) noexcept
+{
+	bool keep = true;
+	try {
+		const answer a = solve(r.day, r.input);
+		const unsigned char status = a.failed;
+		write_all(fd, &status, sizeof status);
+		write_string(fd, a.first);
+		write_string(fd, a.second);
+	} catch (const std::exception&) {
+		keep = false;
+	}
+	replies.post(fd, keep);
+}
+
+void serve(const std::string& path, thread_pool& pool, const solver_type& solve)
+{
+	const sockaddr_un addr = make_address(path);
+	const socket_fd listener{open_socket()};
+	struct stat st;
+	if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+		::unlink(path.c_str());
+	if (::bind(listener.get(), reinterpret_cast<const sockaddr *>(&addr),
+	           sizeof addr) != 0)
+		throw_errno("bind");
+	if (::listen(listener.get(), SOMAXCONN) != 0)
+		throw_errno("listen");
+
+	mailbox replies;
+	std::map<int, connection> conns;
+	std::size_t in_flight = 0;
+	/*
+	 * Hands the next request of a connection to the pool unless one is
+	 * being solved. False if the connection sent a bad frame: dropping it
+	 * is the only way to report that.
+	 */
+	const auto advance = [&](const int fd, connection& c) {
+		try {
+			std::optional<request_frame> r;
+			if (c.busy || !(r = take_request(c.pending)))
+				return true;
+			c.busy = true;
+			++in_flight;
+			pool.submit([fd, r = std::move(*r), &solve, &replies] {
+				answer_request(fd, r, solve, replies);
+			});
+		} catch (const std::exception&) {
+			return false;
+		}
+		return true;
+	};
+	std::vector<pollfd> watched;
+	try {
+		for (;;) {
+			watched.clear();
+			watched.push_back({listener.get(), POLLIN, 0});
+			watched.push_back({replies.fd(), POLLIN, 0});
+			for (const auto& [fd, c] : conns) {
+				if (!c.busy)
+					watched.push_back({fd, POLLIN, 0});
+			}
+			if (::poll(watched.data(), watched.size(), -1) < 0) {
+				if (errno == EINTR)
+					continue;
+				throw_errno("poll");
+			}
+			for (const auto& [fd, keep] : replies.take()) {
+				--in_flight;
+				connection& c = conns.at(fd);
+				c.busy = false;
+				if (!keep || !advance(fd, c))
+					conns.erase(fd);
+			}
+			for (std::size_t i = 2; i < watched.size(); ++i) {
+				if (watched[i].revents == 0)
+					continue;
+				const int fd = watched[i].fd;
+				connection& c = conns.at(fd);
+				if (!receive(fd, c.pending) || !advance(fd, c))
+					conns.erase(fd);
+			}
+			if ((watched[0].revents & POLLIN) == 0)
+				continue;
+			const int fd = ::accept4(listener.get(), nullptr, nullptr,
+			                         SOCK_CLOEXEC);
+			if (fd >= 0)
+				conns.try_emplace(fd, fd);
+			else if (errno != EINTR && errno != ECONNABORTED)
+				throw_errno("accept");
+		}
+	} catch (...) {
+		// Requests being solved still use solve and the mailbox
+		while (in_flight > 0) {
+			pollfd p{replies.fd(), POLLIN, 0};
+			::poll(&p, 1, -1);
+			in_flight -= replies.take().size();
+		}
+		throw;
+	}
+}
+
+answer request(const std::string& path, const std::uint32_t day,
+               const std::string_view input)
+{
+	const sockaddr_un addr = make_address(path);
+	const socket_fd conn{open_socket()};
+	if (::connect(conn.get(), reinterpret_cast<const sockaddr *>(&addr),
+	              sizeof addr) != 0)
+		throw_errno(path.c_str());
+	write_all(conn.get(), &day, sizeof day);
+	write_string(conn.get(), input);
+	unsigned char status;
+	if (!read_all(conn.get(), &status, sizeof status))
+		throw std::runtime_error("Server closed the connection");
+	std::string first = read_string(conn.get());
+	std::string second = read_string(conn.get());
+	return {status != 0, std::move(first), std::move(second)};
+}
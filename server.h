@@ -0,0 +1,53 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef SERVER_H
+#define SERVER_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "thread_pool.h"
+
+/*
+ * Both answers to a request, formatted as the runner prints them. A failed
+ * request carries the error message in first.
+ */
+struct answer {
+	bool failed;
+	std::string first;
+	std::string second;
+};
+
+// Solves the day (counted from 1) on the input, without throwing
+using solver_type = std::function<answer(std::uint32_t, std::string_view)>;
+
+/*
+ * Frames exchanged over the Unix domain socket, in host byte order since both
+ * ends run on the same machine. A request is a 32-bit day number, followed by
+ * the 64-bit length of the input and the input itself. The reply is one byte,
+ * nonzero on failure, then each answer as a 64-bit length and its characters.
+ * A client may send several requests over one connection.
+ *
+ * Puzzle inputs are a few tens of kilobytes and generated ones a few
+ * megabytes; a longer frame is refused by dropping the connection.
+ */
+inline constexpr std::uint64_t max_request_size = std::uint64_t{1} << 24;
+
+/*
+ * Listens on a new socket at path, replacing a stale socket left there. The
+ * calling thread accepts connections and reads their requests, and each
+ * request is solved by a task on the pool, so that an idle connection holds
+ * no worker. A connection has one request solved at a time, which keeps its
+ * replies in order. Only returns by throwing.
+ */
+[[noreturn]] void
+serve(const std::string& path, thread_pool& pool, const solver_type& solve);
+
+// Sends one request to the server listening at path and waits for its reply
+[[nodiscard]] answer request(const std::string& path, std::uint32_t day,
+                             std::string_view input);
+#endif
+#else
+#error This header is for C++20 or later
+#endif
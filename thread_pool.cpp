@@ -0,0 +1,151 @@
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+static thread_local const thread_pool* current_pool = nullptr;
+static thread_local unsigned current_index = 0;
+
+thread_pool::thread_pool(const unsigned num_threads)
+	: queues{std::make_unique<worker_queue[]>(num_threads)}
+{
+	if (num_threads == 0) [[unlikely]]
+		throw std::invalid_argument("Thread pool needs a thread");
+	threads.reserve(num_threads);
+	for (unsigned i = 0; i < num_threads; ++i)
+		threads.emplace_back(&thread_pool::run, this, i);
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		const std::lock_guard lock{sleep_mutex};
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& t : threads)
+		t.join();
+}
+
+void thread_pool::submit(task_type task)
+{
+	unsigned index;
+	if (current_pool == this) {
+		index = current_index;
+	} else {
+		const std::lock_guard lock{sleep_mutex};
+		index = next_queue;
+		next_queue = (next_queue + 1) % size();
+	}
+	submit(index, std::move(task));
+}
+
+void thread_pool::submit(const unsigned worker, task_type task)
+{
+	if (worker >= size()) [[unlikely]]
+		throw std::out_of_range("No such worker in thread pool");
+	{
+		worker_queue& q = queues[worker];
+		const std::lock_guard lock{q.mutex};
+		q.tasks.push_back(std::move(task));
+	}
+	{
+		const std::lock_guard lock{sleep_mutex};
+		++queued;
+	}
+	wake.notify_one();
+}
+
+void thread_pool::submit_helper(task_type task)
+{
+	{
+		const std::lock_guard lock{helpers.mutex};
+		helpers.tasks.push_back(std::move(task));
+	}
+	{
+		const std::lock_guard lock{sleep_mutex};
+		++queued;
+	}
+	wake.notify_one();
+}
+
+/*
+ * Hands a list of tasks to each worker, which runs them in order unless other
+ * workers steal some. No worker starts before the whole plan is queued.
+ */
+void thread_pool::submit_plan(std::vector<std::vector<task_type>> plan)
+{
+	if (plan.size() > size()) [[unlikely]]
+		throw std::out_of_range("Plan has too many workers");
+	std::size_t total = 0;
+	for (unsigned w = 0; w < plan.size(); ++w) {
+		worker_queue& q = queues[w];
+		const std::lock_guard lock{q.mutex};
+		for (auto it = plan[w].rbegin(); it != plan[w].rend(); ++it)
+			q.tasks.push_back(std::move(*it));
+		total += plan[w].size();
+	}
+	{
+		const std::lock_guard lock{sleep_mutex};
+		queued += total;
+	}
+	wake.notify_all();
+}
+
+void thread_pool::run(const unsigned index)
+{
+	current_pool = this;
+	current_index = index;
+	for (;;) {
+		{
+			std::unique_lock lock{sleep_mutex};
+			wake.wait(lock,
+			          [this] { return queued > 0 || stopping; });
+			if (queued == 0)
+				return;
+			// Claiming a task here guarantees one is left to find
+			--queued;
+		}
+		task_type task;
+		while (!try_pop(index, task) && !try_steal(index, task));
+		task();
+	}
+}
+
+bool thread_pool::try_pop(const unsigned index, task_type& task)
+{
+	worker_queue& q = queues[index];
+	const std::lock_guard lock{q.mutex};
+	if (q.tasks.empty())
+		return false;
+	task = std::move(q.tasks.back());
+	q.tasks.pop_back();
+	return true;
+}
+
+bool thread_pool::try_steal(const unsigned thief, task_type& task)
+{
+	{
+		const std::lock_guard lock{helpers.mutex};
+		if (!helpers.tasks.empty()) {
+			task = std::move(helpers.tasks.front());
+			helpers.tasks.pop_front();
+			return true;
+		}
+	}
+	for (unsigned k = 1; k < size(); ++k) {
+		worker_queue& q = queues[(thief + k) % size()];
+		const std::lock_guard lock{q.mutex};
+		if (q.tasks.empty())
+			continue;
+		task = std::move(q.tasks.front());
+		q.tasks.pop_front();
+		return true;
+	}
+	return false;
+}
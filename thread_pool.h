@@ -0,0 +1,67 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool. Each worker owns a deque of tasks: it pops its
+ * own tasks from the back and, when it runs out, takes helper tasks from a
+ * shared queue, then steals from the front of the other workers' deques.
+ * Tasks submitted from inside a worker go to that worker's deque. Tasks must
+ * not throw; the destructor runs every task left before joining the workers.
+ */
+class thread_pool {
+public:
+	using task_type = std::function<void()>;
+
+	explicit thread_pool(unsigned num_threads);
+	thread_pool(const thread_pool&) = delete;
+	~thread_pool();
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	void submit(task_type task);
+	void submit(unsigned worker, task_type task);
+	void submit_plan(std::vector<std::vector<task_type>> plan);
+	// Runs before any task stolen from a worker, so that work helping a
+	// running task is not left behind the rest of a plan
+	void submit_helper(task_type task);
+
+	[[nodiscard]] unsigned size() const noexcept {
+		return static_cast<unsigned>(threads.size());
+	}
+
+	[[nodiscard]] std::thread::native_handle_type
+	native_handle(const unsigned worker) {
+		return threads.at(worker).native_handle();
+	}
+
+private:
+	struct worker_queue {
+		std::mutex mutex{};
+		std::deque<task_type> tasks{};
+	};
+
+	void run(unsigned index);
+	bool try_pop(unsigned index, task_type& task);
+	bool try_steal(unsigned thief, task_type& task);
+
+	std::unique_ptr<worker_queue[]> queues;
+	worker_queue helpers{};
+	std::vector<std::thread> threads{};
+	std::mutex sleep_mutex{};
+	std::condition_variable wake{};
+	std::size_t queued = 0;
+	unsigned next_queue = 0;
+	bool stopping = false;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "watchdog.h"
+
+watchdog::watchdog(const clock::duration b)
+	: limit{b}
+	, thread{[this](std::stop_token s) { run(std::move(s)); }}
+{}
+
+watchdog::timer::timer(watchdog& w)
+	: owner{w}
+	, id{}
+{
+	std::stop_source source;
+	stop = source.get_token();
+	id = owner.start(std::move(source));
+}
+
+watchdog::timer::~timer()
+{
+	owner.finish(id);
+}
+
+// Returns the identifier of the new entry
+std::uint64_t watchdog::start(std::stop_source source)
+{
+	std::uint64_t id;
+	{
+		const std::lock_guard lock{mutex};
+		id = next_id++;
+		entries.push_back({clock::now() + limit, id,
+		                   std::move(source)});
+	}
+	wake.notify_one();
+	return id;
+}
+
+void watchdog::finish(const std::uint64_t id)
+{
+	const std::lock_guard lock{mutex};
+	std::erase_if(entries, [id](const entry& e) { return e.id == id; });
+}
+
+void watchdog::run(const std::stop_token stop)
+{
+	std::unique_lock lock{mutex};
+	while (!stop.stop_requested()) {
+		if (entries.empty()) {
+			wake.wait(lock, stop, [this] { return !entries.empty(); });
+			continue;
+		}
+		const clock::time_point deadline = entries.front().deadline;
+		// Only the stop request or the deadline end the wait
+		wake.wait_until(lock, stop, deadline, [] { return false; });
+		const auto now = clock::now();
+		auto it = entries.begin();
+		for (; it != entries.end() && it->deadline <= now; ++it)
+			it->source.request_stop();
+		entries.erase(entries.begin(), it);
+	}
+}
@@ -0,0 +1,69 @@
+#if defined __cplusplus && __cplusplus >= 202002L
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/*
+ * Thread asking tasks to stop once they have run for longer than a budget.
+ * Stopping is cooperative: tasks watch the token of their timer and may run
+ * a little past their budget before noticing.
+ */
+class watchdog {
+public:
+	using clock = std::chrono::steady_clock;
+
+	// Times one task from its creation to its destruction
+	class timer {
+	public:
+		explicit timer(watchdog& w);
+		timer(const timer&) = delete;
+		timer& operator=(const timer&) = delete;
+		~timer();
+
+		[[nodiscard]] std::stop_token token() const noexcept {
+			return stop;
+		}
+
+	private:
+		watchdog& owner;
+		std::uint64_t id;
+		std::stop_token stop{};
+	};
+
+	explicit watchdog(clock::duration b);
+	watchdog(const watchdog&) = delete;
+	watchdog& operator=(const watchdog&) = delete;
+
+	[[nodiscard]] clock::duration budget() const noexcept {
+		return limit;
+	}
+
+private:
+	struct entry {
+		clock::time_point deadline;
+		std::uint64_t id;
+		std::stop_source source;
+	};
+
+	std::uint64_t start(std::stop_source source);
+	void run(std::stop_token stop);
+	void finish(std::uint64_t id);
+
+	clock::duration limit;
+	std::mutex mutex{};
+	std::condition_variable_any wake{};
+	// Sorted by deadline since every task has the same budget
+	std::vector<entry> entries{};
+	std::uint64_t next_id = 0;
+	std::jthread thread;
+};
+#endif
+#else
+#error This header is for C++20 or later
+#endif